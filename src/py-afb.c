@@ -39,6 +39,12 @@
 // global afbMain glue
 GlueHandleT* afbMain = NULL;
 
+// all entry points use the fastcall convention: arguments are received as a
+// C array, without building an intermediate tuple
+#define GLUE_FASTCALL(func) (PyCFunction)(void (*)(void))(func), METH_FASTCALL
+#define GLUE_FASTCALL_KW(func)                                                 \
+    (PyCFunction)(void (*)(void))(func), METH_FASTCALL | METH_KEYWORDS
+
 typedef struct
 {
     PyObject_HEAD PyObject* statusP;
@@ -117,43 +123,84 @@ static PyTypeObject PyResponseType = {
     .tp_members = PyResponseMembers,
 };
 
+// build a libafb.response from a subcall status and replies
+PyObject*
+PyResponseNew(int status, unsigned nreplies, const afb_data_t* replies)
+{
+    const char* errorMsg;
+    PyResponseObjectT* response =
+      (PyResponseObjectT*)PyResponseNewCb(&PyResponseType, NULL, NULL);
+    if (!response)
+        return NULL;
+
+    response->statusP = PyLong_FromLong(status);
+    response->argsP = PyTuple_New(nreplies);
+    if (!response->statusP || !response->argsP)
+        goto OnErrorExit;
+    errorMsg = PyPushAfbReply(response->argsP, 0, nreplies, replies);
+    if (errorMsg) {
+        PyErr_SetString(PyExc_RuntimeError, errorMsg);
+        goto OnErrorExit;
+    }
+    return (PyObject*)response;
+
+OnErrorExit:
+    Py_DECREF(response);
+    return NULL;
+}
+
 static PyObject*
-GluePrintInfo(PyObject* self, PyObject* argsP)
+GluePrintInfo(PyObject* self,
+              PyObject* const* argsP,
+              Py_ssize_t nargs,
+              PyObject* kwnames)
 {
-    PyPrintMsg(AFB_SYSLOG_LEVEL_INFO, self, argsP);
+    PyPrintMsg(AFB_SYSLOG_LEVEL_INFO, self, argsP, nargs, kwnames);
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GluePrintError(PyObject* self, PyObject* argsP)
+GluePrintError(PyObject* self,
+               PyObject* const* argsP,
+               Py_ssize_t nargs,
+               PyObject* kwnames)
 {
-    PyPrintMsg(AFB_SYSLOG_LEVEL_ERROR, self, argsP);
+    PyPrintMsg(AFB_SYSLOG_LEVEL_ERROR, self, argsP, nargs, kwnames);
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GluePrintWarning(PyObject* self, PyObject* argsP)
+GluePrintWarning(PyObject* self,
+                 PyObject* const* argsP,
+                 Py_ssize_t nargs,
+                 PyObject* kwnames)
 {
-    PyPrintMsg(AFB_SYSLOG_LEVEL_WARNING, self, argsP);
+    PyPrintMsg(AFB_SYSLOG_LEVEL_WARNING, self, argsP, nargs, kwnames);
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GluePrintNotice(PyObject* self, PyObject* argsP)
+GluePrintNotice(PyObject* self,
+                PyObject* const* argsP,
+                Py_ssize_t nargs,
+                PyObject* kwnames)
 {
-    PyPrintMsg(AFB_SYSLOG_LEVEL_NOTICE, self, argsP);
+    PyPrintMsg(AFB_SYSLOG_LEVEL_NOTICE, self, argsP, nargs, kwnames);
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GluePrintDebug(PyObject* self, PyObject* argsP)
+GluePrintDebug(PyObject* self,
+               PyObject* const* argsP,
+               Py_ssize_t nargs,
+               PyObject* kwnames)
 {
-    PyPrintMsg(AFB_SYSLOG_LEVEL_DEBUG, self, argsP);
+    PyPrintMsg(AFB_SYSLOG_LEVEL_DEBUG, self, argsP, nargs, kwnames);
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GlueBinderConf(PyObject* self, PyObject* argsP)
+GlueBinderConf(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: binder(config)";
     json_object* configJ = NULL;
@@ -175,10 +222,11 @@ GlueBinderConf(PyObject* self, PyObject* argsP)
     PyEval_InitThreads(); // from 3.7 this is useless
 #endif
 
-    if (!PyArg_ParseTuple(argsP, "O", &afbMain->binder.configP)) {
+    if (nargs != 1) {
         errorMsg = "invalid config object";
         goto OnErrorExit;
     }
+    afbMain->binder.configP = argsP[0];
 
     int hasError = 0;
     configJ = pyObjToJson(afbMain->binder.configP, &hasError);
@@ -215,6 +263,37 @@ OnErrorExit:
     return NULL;
 }
 
+// register the monitoring verb asked by api config 'stats': True or a name
+static const char*
+GlueStatsVerbAdd(GlueHandleT* glue)
+{
+    const char* name = "stats";
+    PyObject* statsP = PyDict_GetItemString(glue->api.configP, "stats");
+    if (!statsP || PyObject_IsTrue(statsP) != 1) {
+        PyErr_Clear();
+        return NULL;
+    }
+    if (PyUnicode_Check(statsP)) {
+        name = PyUnicode_AsUTF8(statsP);
+        if (!name) {
+            PyErr_Clear();
+            return "invalid stats verb name";
+        }
+    }
+
+    // vcbdata is the api glue, as for info, not a python verb
+    if (afb_api_add_verb(glue->api.afb,
+                         name,
+                         "binding statistics",
+                         GlueStatsVerbCb,
+                         glue,
+                         NULL,
+                         0,
+                         0) < 0)
+        return "fail to register stats verb";
+    return NULL;
+}
+
 typedef enum
 {
     addApiAdd,
@@ -223,7 +302,10 @@ typedef enum
 } addApiHow;
 
 static PyObject*
-addApi(PyObject* self, PyObject* argsP, addApiHow how)
+addApi(PyObject* self,
+       PyObject* const* argsP,
+       Py_ssize_t nargs,
+       addApiHow how)
 {
     const char* errorMsg = "syntax: apiadd (config)";
 
@@ -238,9 +320,11 @@ addApi(PyObject* self, PyObject* argsP, addApiHow how)
         goto OnErrorExit;
     }
     glue->magic = GLUE_API_MAGIC_TAG;
+    pthread_mutex_init(&glue->api.infoMutex, NULL);
 
-    if (!PyArg_ParseTuple(argsP, "O", &glue->api.configP))
+    if (nargs != 1)
         goto OnErrorExit;
+    glue->api.configP = argsP[0];
     int hasError = 0;
     json_object* configJ = pyObjToJson(glue->api.configP, &hasError);
     if (hasError) {
@@ -267,6 +351,15 @@ addApi(PyObject* self, PyObject* argsP, addApiHow how)
             }
             usrApiCb = GlueCtrlCb;
         }
+
+        // precompute python verbs and event handlers context, requests may
+        // reach the api before AfbApiCreate returns
+        errorMsg = GlueVerbsPrepare(glue, configJ);
+        if (!errorMsg)
+            errorMsg = GlueEventsCompile(configJ);
+        if (errorMsg)
+            goto OnErrorExit;
+
         Py_BEGIN_ALLOW_THREADS errorMsg = AfbApiCreate(afbMain->binder.afb,
                                                        configJ,
                                                        &glue->api.afb,
@@ -276,6 +369,12 @@ addApi(PyObject* self, PyObject* argsP, addApiHow how)
                                                        GlueApiEventCb,
                                                        glue);
         Py_END_ALLOW_THREADS
+
+        // store python verbs dispatch records in their vcbdata
+        if (!errorMsg)
+            errorMsg = GlueVerbsCompile(glue->api.afb);
+        if (!errorMsg)
+            errorMsg = GlueStatsVerbAdd(glue);
     }
     if (errorMsg)
         goto OnErrorExit;
@@ -292,31 +391,31 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueApiAdd(PyObject* self, PyObject* argsP)
+GlueApiAdd(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    return addApi(self, argsP, addApiAdd);
+    return addApi(self, argsP, nargs, addApiAdd);
 }
 
 static PyObject*
-GlueApiImport(PyObject* self, PyObject* argsP)
+GlueApiImport(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    return addApi(self, argsP, addApiImport);
+    return addApi(self, argsP, nargs, addApiImport);
 }
 
 static PyObject*
-GlueApiCreate(PyObject* self, PyObject* argsP)
+GlueApiCreate(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    return addApi(self, argsP, addApiCreate);
+    return addApi(self, argsP, nargs, addApiCreate);
 }
 
 // this routine execute within mainloop context when binder is ready to go
 static PyObject*
-GlueLoopStart(PyObject* self, PyObject* argsP)
+GlueLoopStart(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: loopstart(binder,[callback],[userdata])";
     int status;
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count < 1 || count > 3)
         goto OnErrorExit;
 
@@ -326,13 +425,12 @@ GlueLoopStart(PyObject* self, PyObject* argsP)
         goto OnErrorExit;
     }
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || !GlueGetApi(glue))
         goto OnErrorExit;
 
     if (count >= 2) {
-        async->callbackP = PyTuple_GetItem(argsP, 1);
+        async->callbackP = argsP[1];
         if (async->callbackP) {
             if (!PyCallable_Check(async->callbackP))
                 goto OnErrorExit;
@@ -341,7 +439,7 @@ GlueLoopStart(PyObject* self, PyObject* argsP)
     }
 
     if (count >= 3) {
-        async->userdataP = PyTuple_GetItem(argsP, 2);
+        async->userdataP = argsP[2];
         if (async->userdataP == Py_None)
             async->userdataP = NULL;
         else if (async->userdataP)
@@ -364,14 +462,17 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueGetConfig(PyObject* self, PyObject* argsP)
+GlueGetConfig(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: config(handle[,key])";
     PyObject *capsuleP, *configP, *resultP, *slotP, *keyP = NULL;
-    if (!PyArg_ParseTuple(argsP, "O|O", &capsuleP, &keyP))
+    if (nargs < 1 || nargs > 2)
         goto OnErrorExit;
+    capsuleP = argsP[0];
+    if (nargs > 1)
+        keyP = argsP[1];
 
-    GlueHandleT* glue = PyCapsule_GetPointer(capsuleP, GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(capsuleP);
     if (!glue)
         goto OnErrorExit;
 
@@ -417,50 +518,49 @@ OnErrorExit:
     return NULL;
 }
 
+// reply to a request, argsP[0] is the status, following slots the reply data
 static PyObject*
-GlueReply(PyObject* self, PyObject* argsP)
+GlueReplyArgs(GlueHandleT* glue, PyObject* const* argsP, Py_ssize_t count)
 {
     const char* errorMsg = "syntax: reply(rqt, status, [arg1 ... argn])";
     PyObject* slotP;
-    long status, count = 0;
+    long status;
+    GlueDataArrayT reply;
 
-    count = PyTuple_GET_SIZE(argsP);
-    afb_data_t reply[count];
-
-    slotP = PyTuple_GetItem(argsP, 0);
-    GlueHandleT* glue = PyCapsule_GetPointer(slotP, GLUE_AFB_UID);
-    if (!glue || glue->magic != GLUE_RQT_MAGIC_TAG)
-        goto OnErrorExit0;
-
-    if (count < 2)
+    if (count < 1)
         goto OnErrorExit;
 
-    json_object* slotJ;
-    slotP = PyTuple_GetItem(argsP, 1);
+    slotP = argsP[0];
     if (!PyLong_Check(slotP)) {
         errorMsg = "syntax: invalid status should be integer";
         goto OnErrorExit;
     }
     status = PyLong_AsLong(slotP);
 
-    for (long idx = 0; idx < count - 2; idx++) {
-        slotP = PyTuple_GetItem(argsP, idx + 2);
-        int hasError = 0;
-        slotJ = pyObjToJson(slotP, &hasError);
-        if (hasError) {
-            errorMsg = "(hoops) not json convertible response";
+    // scalar and binary replies keep their afb type, containers follow the
+    // verb encoding
+    GlueEncodingE encoding =
+      glue->rqt.verb ? glue->rqt.verb->encoding : GLUE_ENCODING_JSONC;
+    if (!GlueDataArrayInit(&reply, (size_t)count)) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+    uint64_t encodeStart = GlueNowNs();
+    for (long idx = 0; idx < count - 1; idx++) {
+        if (!GlueReplyConvert(
+              argsP[idx + 1], &reply.data[idx], (int)idx + 1, encoding)) {
+            afb_data_array_unref((unsigned)idx, reply.data);
+            GlueDataArrayRelease(&reply);
+            errorMsg = "(hoops) unsupported response type";
             goto OnErrorExit;
         }
-        afb_create_data_raw(&reply[idx],
-                            AFB_PREDEFINED_TYPE_JSON_C,
-                            slotJ,
-                            0,
-                            (void*)json_object_put,
-                            slotJ);
     }
+    if (glue->rqt.verb)
+        GlueHistoAdd(&glue->rqt.verb->encode, GlueNowNs() - encodeStart);
 
     // respond request and free ressources.
-    GlueAfbReply(glue, status, count - 2, reply);
+    GlueAfbReply(glue, status, count - 1, reply.data);
+    GlueDataArrayRelease(&reply);
     Py_RETURN_NONE;
 
 OnErrorExit: {
@@ -475,18 +575,32 @@ OnErrorExit: {
                         errorJ);
     GlueAfbReply(glue, -1, 1, &reply);
 }
-OnErrorExit0:
     Py_RETURN_NONE;
 }
 
 static PyObject*
-GlueBindingLoad(PyObject* self, PyObject* argsP)
+GlueReply(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    long count = nargs;
+    if (count < 1)
+        Py_RETURN_NONE;
+
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue || glue->magic != GLUE_RQT_MAGIC_TAG)
+        Py_RETURN_NONE;
+
+    return GlueReplyArgs(glue, argsP + 1, count - 1);
+}
+
+static PyObject*
+GlueBindingLoad(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: binding(config)";
     PyObject* configP;
 
-    if (!PyArg_ParseTuple(argsP, "O", &configP))
+    if (nargs != 1)
         goto OnErrorExit;
+    configP = argsP[0];
 
     int hasError = 0;
     json_object* configJ = pyObjToJson(configP, &hasError);
@@ -508,107 +622,8 @@ OnErrorExit:
     return NULL;
 }
 
-// ------------------------------------------------------------
-// Conversion of a PyObject* to afb_data_t
-// ------------------------------------------------------------
-bool
-_convert_py_argument_to_afb_data(PyObject* pyArg, afb_data_t* out, int index)
-{
-    if (pyArg == Py_None) {
-        // None can be represented as JSON "null"
-        if (afb_create_data_raw(
-              out, AFB_PREDEFINED_TYPE_JSON_C, NULL, 0, NULL, NULL) != 0) {
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create null parameter");
-            return false;
-        }
-    } else if (PyFloat_Check(pyArg)) {
-        double val = PyFloat_AsDouble(pyArg);
-        if (afb_create_data_copy(
-              out, AFB_PREDEFINED_TYPE_DOUBLE, &val, sizeof(val)) != 0) {
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create double parameter");
-            return false;
-        }
-    } else if (PyUnicode_Check(pyArg)) {
-        const char* str = PyUnicode_AsUTF8(pyArg);
-        if (!str) {
-            PyErr_SetString(PyExc_UnicodeError,
-                            "Failed to convert string to UTF-8");
-            return false;
-        }
-        Py_INCREF(pyArg);
-        if (afb_create_data_raw(out,
-                                AFB_PREDEFINED_TYPE_STRINGZ,
-                                str,
-                                strlen(str) + 1,
-                                (void (*)(void*))Py_DecRef,
-                                pyArg) != 0) {
-            Py_DECREF(pyArg);
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create string parameter");
-            return false;
-        }
-    } else if (PyBool_Check(pyArg)) {
-        bool bval = (pyArg == Py_True);
-        if (afb_create_data_copy(
-              out, AFB_PREDEFINED_TYPE_BOOL, &bval, sizeof(bval)) != 0) {
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create boolean parameter");
-            return false;
-        }
-    } else if (PyDict_Check(pyArg) || PyList_Check(pyArg)) {
-        int hasError = 0;
-        json_object* jobj = pyObjToJson(pyArg, &hasError);
-        if (hasError) {
-            PyErr_SetString(PyExc_TypeError,
-                            "Failed to convert Python object to JSON");
-            return false;
-        }
-        if (afb_create_data_raw(out,
-                                AFB_PREDEFINED_TYPE_JSON_C,
-                                jobj,
-                                0,
-                                (void*)json_object_put,
-                                jobj) != 0) {
-            json_object_put(jobj);
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create JSON parameter");
-            return false;
-        }
-    } else if (PyLong_Check(pyArg)) {
-        int64_t i64_value = PyLong_AsLongLong(pyArg);
-        if (i64_value == -1 && PyErr_Occurred()) {
-            PyErr_SetString(PyExc_OverflowError, "Integer value too large");
-            return false;
-        }
-        if (afb_create_data_copy(
-              out, AFB_PREDEFINED_TYPE_I64, &i64_value, sizeof(int64_t)) != 0) {
-            PyErr_SetString(PyExc_RuntimeError,
-                            "Failed to create integer parameter");
-            return false;
-        }
-    } else {
-        PyErr_Format(PyExc_TypeError, "Unsupported type at position %d", index);
-        return false;
-    }
-
-    return true;
-}
-
-static void
-_unref_afb_params(afb_data_t* params, long count)
-{
-    for (long idx = 0; idx < count; idx++) {
-        if (params[idx]) {
-            afb_data_unref(params[idx]);
-            params[idx] = NULL;
-        }
-    }
-}
-
 static PyObject*
-GlueCallAsync(PyObject* self, PyObject* argsP)
+GlueCallAsync(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     bool reportError = true;
     const char* errorMsg =
@@ -617,33 +632,35 @@ GlueCallAsync(PyObject* self, PyObject* argsP)
     long params_count = 0;
     GlueCallHandleT* handle = NULL;
     PyObject* userdataP = NULL;
+    afb_data_t* params;
+    GlueDataArrayT paramsA;
 
     // parse input arguments
-    long count = PyTuple_GET_SIZE(argsP);
-    afb_data_t params[count];
-    memset(params, 0, sizeof(params));
+    long count = nargs;
+    params = GlueDataArrayInit(&paramsA, (size_t)count);
+    if (!params)
+        return PyErr_NoMemory();
     if (count < 5)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
-    const char* apiname = PyUnicode_AsUTF8(PyTuple_GetItem(argsP, 1));
+    const char* apiname = PyUnicode_AsUTF8(argsP[1]);
     if (!apiname)
         goto OnErrorExit;
 
-    const char* verbname = PyUnicode_AsUTF8(PyTuple_GetItem(argsP, 2));
+    const char* verbname = PyUnicode_AsUTF8(argsP[2]);
     if (!verbname)
         goto OnErrorExit;
 
-    PyObject* callbackP = PyTuple_GetItem(argsP, 3);
+    PyObject* callbackP = argsP[3];
     // check callback is a valid function
     if ((callbackP != Py_None) && !PyCallable_Check(callbackP))
         goto OnErrorExit;
 
-    userdataP = PyTuple_GetItem(argsP, 4);
+    userdataP = argsP[4];
     if (userdataP == Py_None)
         userdataP = NULL;
     else
@@ -651,7 +668,7 @@ GlueCallAsync(PyObject* self, PyObject* argsP)
 
     // retrieve subcall api argument(s)
     for (index = 0; index < count - 5; index++) {
-        PyObject* pyArg = PyTuple_GetItem(argsP, index + 5);
+        PyObject* pyArg = argsP[index + 5];
         if (!_convert_py_argument_to_afb_data(
               pyArg, &params[index], index + 5)) {
             errorMsg = "invalid argument type";
@@ -662,7 +679,7 @@ GlueCallAsync(PyObject* self, PyObject* argsP)
     params_count = index;
 
     if (callbackP != Py_None) {
-        handle = calloc(1, sizeof(GlueCallHandleT));
+        handle = GluePoolAlloc(GLUE_POOL_CALL);
         if (handle == NULL) {
             errorMsg = "out of memory";
             goto OnErrorExit;
@@ -704,16 +721,18 @@ GlueCallAsync(PyObject* self, PyObject* argsP)
     }
 
     afb_data_array_unref((unsigned)params_count, params);
+    GlueDataArrayRelease(&paramsA);
     Py_XDECREF(userdataP);
     Py_RETURN_NONE;
 
 OnErrorExit:
     afb_data_array_unref((unsigned)params_count, params);
+    GlueDataArrayRelease(&paramsA);
     Py_XDECREF(userdataP);
     if (handle) {
         Py_XDECREF(handle->async.callbackP);
         Py_XDECREF(handle->async.userdataP);
-        free(handle);
+        GluePoolFree(GLUE_POOL_CALL, handle);
     }
     if (reportError) {
         GLUE_DBG_ERROR(afbMain, errorMsg);
@@ -722,134 +741,361 @@ OnErrorExit:
     return NULL;
 }
 
+// awaitable subcall: call(handle, api, verb, ...) returns an asyncio future
+// of the calling coroutine loop, resolved with a libafb.response
 static PyObject*
-GlueCallSync(PyObject* self, PyObject* argsP)
+GlueCallAwait(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    bool reportError = true;
-    const char* errorMsg = "syntax: callsync(handle, api, verb, ...)";
-    int err, status;
-    long index = 0, count = PyTuple_GET_SIZE(argsP);
-    long params_count = 0;
-    int params_handed_to_libafb = 0;
-    afb_data_t params[count];
-    unsigned nreplies = SUBCALL_MAX_RPLY;
-    afb_data_t replies[SUBCALL_MAX_RPLY];
-    PyObject* paramsP = NULL;
-    PyObject* replyP = NULL;
-    PyObject* resultP = NULL;
-
-    memset(params, 0, sizeof(params));
-    memset(replies, 0, sizeof(replies));
+    const char* errorMsg = "syntax: await call(handle, api, verb, ...)";
+    GlueCallHandleT* handle = NULL;
+    PyObject* futureP = NULL;
+    afb_data_t* params;
+    GlueDataArrayT paramsA = { 0 };
+    long index = 0;
 
-    // parse input arguments
-    if (count < 3)
+    if (nargs < 3)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
-    if (!glue)
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue || (glue->magic != GLUE_RQT_MAGIC_TAG && !GlueGetApi(glue)))
         goto OnErrorExit;
-
-    const char* apiname = PyUnicode_AsUTF8(PyTuple_GetItem(argsP, 1));
-    if (!apiname)
+    const char* apiname = PyUnicode_AsUTF8(argsP[1]);
+    const char* verbname = PyUnicode_AsUTF8(argsP[2]);
+    if (!apiname || !verbname)
         goto OnErrorExit;
 
-    const char* verbname = PyUnicode_AsUTF8(PyTuple_GetItem(argsP, 2));
-    if (!verbname)
-        goto OnErrorExit;
+    // raises RuntimeError when not called from a coroutine
+    futureP = GlueAioFutureNew();
+    if (!futureP)
+        return NULL;
 
-    // retrieve subcall api argument(s)
-    for (index = 0; index < count - 3; index++) {
-        PyObject* pyArg = PyTuple_GetItem(argsP, index + 3);
+    params = GlueDataArrayInit(&paramsA, (size_t)nargs - 3);
+    if (!params) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+    for (index = 0; index < nargs - 3; index++) {
         if (!_convert_py_argument_to_afb_data(
-              pyArg, &params[index], index + 3)) {
-            errorMsg = "invalid argument type";
-            reportError = false;
-            goto OnErrorExit;
+              argsP[index + 3], &params[index], (int)index + 3)) {
+            afb_data_array_unref((unsigned)index, params);
+            GlueDataArrayRelease(&paramsA);
+            Py_DECREF(futureP);
+            return NULL;
         }
     }
-    params_count = index;
+
+    handle = GluePoolAlloc(GLUE_POOL_CALL);
+    if (handle == NULL) {
+        afb_data_array_unref((unsigned)index, params);
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+    handle->magic = GLUE_CALL_MAGIC_TAG;
+    handle->glue = glue;
+    handle->async.userdataP = AFB_Py_NewRef(futureP);
+
+    // params are handed to libafb, the callback releases the handle
+    if (glue->magic == GLUE_RQT_MAGIC_TAG) {
+        Py_BEGIN_ALLOW_THREADS afb_req_subcall(glue->rqt.afb,
+                                               apiname,
+                                               verbname,
+                                               (int)index,
+                                               params,
+                                               afb_req_subcall_catch_events,
+                                               GlueRqtFutureCb,
+                                               (void*)handle);
+        Py_END_ALLOW_THREADS
+    } else {
+        Py_BEGIN_ALLOW_THREADS afb_api_call(GlueGetApi(glue),
+                                            apiname,
+                                            verbname,
+                                            (int)index,
+                                            params,
+                                            GlueApiFutureCb,
+                                            (void*)handle);
+        Py_END_ALLOW_THREADS
+    }
+    GlueDataArrayRelease(&paramsA);
+    return futureP;
+
+OnErrorExit:
+    GlueDataArrayRelease(&paramsA);
+    Py_XDECREF(futureP);
+    GLUE_DBG_ERROR(afbMain, errorMsg);
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+// return the asyncio loop bridged with the binder
+static PyObject*
+GlueAioLoopGet(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    PyObject* loopP = GlueAioLoop();
+    return loopP ? AFB_Py_NewRef(loopP) : NULL;
+}
+
+// schedule a coroutine on the bridge loop from any binder callback
+static PyObject*
+GlueAioStart(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    if (nargs != 1) {
+        PyErr_SetString(PyExc_RuntimeError, "syntax: aiorun(coroutine)");
+        return NULL;
+    }
+    return GlueAioRun(argsP[0]);
+}
+
+// allocate a barrier for count subcalls, usage is raised when launched
+static GlueCallManyT*
+GlueCallManyNew(GlueHandleT* glue, size_t count)
+{
+    GlueCallManyT* many =
+      calloc(1, sizeof(GlueCallManyT) + count * sizeof(GlueCallItemT));
+    if (!many)
+        return NULL;
+
+    pthread_mutex_init(&many->mutex, NULL);
+    many->glue = glue;
+    many->usage = 1;
+    many->count = (unsigned)count;
+    many->pending = (unsigned)count;
+    for (size_t idx = 0; idx < count; idx++)
+        many->items[idx].many = many;
+    return many;
+}
+
+// launch barrier subcalls and wait for them with the GIL released, timeout 0
+// waits forever. Returns 0 when nothing was launched, params are then still
+// owned by the caller.
+static int
+GlueCallManyWait(GlueCallManyT* many, int timeout)
+{
+    int started;
+
+    // afb_sched_sync only bounds the enter callback, the timeout of the
+    // subcalls is enforced by a timer leaving the lock
+    many->timeout = timeout;
+    Py_BEGIN_ALLOW_THREADS
+    afb_sched_sync(0, GlueCallManyEnterCb, many);
+    Py_END_ALLOW_THREADS
+
+    // the lock is left under the mutex: once taken, late completions and
+    // the timer drop their replies and leave no lock
+    pthread_mutex_lock(&many->mutex);
+    many->abandoned = 1;
+    started = many->lock != NULL;
+    many->lock = NULL;
+    pthread_mutex_unlock(&many->mutex);
+    return started;
+}
+
+// synchronous subcall, argsP[0] is the api, argsP[1] the verb and following
+// slots the subcall parameters. argBase is argsP[0] position for error report.
+// Replies are collected by a one call barrier, whatever their count.
+static PyObject*
+GlueCallSyncArgs(GlueHandleT* glue,
+                 PyObject* const* argsP,
+                 Py_ssize_t count,
+                 int argBase)
+{
+    bool reportError = true;
+    const char* errorMsg = "syntax: callsync(handle, api, verb, ...)";
+    long index = 0;
+    long params_count = 0;
+    GlueDataArrayT params = { 0 };
+    GlueCallManyT* many = NULL;
+    GlueCallItemT* item;
+    PyObject* resultP;
+
+    // parse input arguments
+    if (count < 2)
+        goto OnErrorExit;
 
     switch (glue->magic) {
         case GLUE_RQT_MAGIC_TAG:
-            Py_BEGIN_ALLOW_THREADS err =
-              afb_req_subcall_sync(glue->rqt.afb,
-                                   apiname,
-                                   verbname,
-                                   (int)index,
-                                   params,
-                                   afb_req_subcall_catch_events,
-                                   &status,
-                                   &nreplies,
-                                   replies);
-            Py_END_ALLOW_THREADS break;
         case GLUE_JOB_MAGIC_TAG:
         case GLUE_API_MAGIC_TAG:
         case GLUE_BINDER_MAGIC_TAG:
-            Py_BEGIN_ALLOW_THREADS err = afb_api_call_sync(GlueGetApi(glue),
-                                                           apiname,
-                                                           verbname,
-                                                           (int)index,
-                                                           params,
-                                                           &status,
-                                                           &nreplies,
-                                                           replies);
-            Py_END_ALLOW_THREADS break;
-
+            break;
         default:
             errorMsg = "handle should be a req|api";
             goto OnErrorExit;
     }
 
-    /*
-     * The synchronous AFB call owns or tracks the submitted parameters after
-     * the call boundary. Do not release them locally after the native call has
-     * accepted them.
-     */
-    params_handed_to_libafb = 1;
-    params_count = 0;
+    many = GlueCallManyNew(glue, 1);
+    if (!many || !GlueDataArrayInit(&params, (size_t)count - 2)) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+    item = &many->items[0];
 
-    if (PyErr_Occurred()) {
-        afb_data_array_unref(nreplies, replies);
-        return NULL;
+    item->api = PyUnicode_AsUTF8(argsP[0]);
+    if (!item->api)
+        goto OnErrorExit;
+
+    item->verb = PyUnicode_AsUTF8(argsP[1]);
+    if (!item->verb)
+        goto OnErrorExit;
+
+    // retrieve subcall api argument(s)
+    for (index = 0; index < count - 2; index++) {
+        PyObject* pyArg = argsP[index + 2];
+        if (!_convert_py_argument_to_afb_data(
+              pyArg, &params.data[index], (int)index + argBase + 2)) {
+            errorMsg = "invalid argument type";
+            reportError = false;
+            goto OnErrorExit;
+        }
+        params_count = index + 1;
     }
-    if (err) {
-        status = err;
+    item->params = params.data;
+    item->nparams = (unsigned)params_count;
+
+    // launched params are handed to libafb
+    if (GlueCallManyWait(many, 0))
+        params_count = 0;
+    if (!item->done) {
         errorMsg = "api subcall fail";
         goto OnErrorExit;
     }
+    GlueDataArrayRelease(&params);
 
-    // retreive response and build Python response
-    paramsP = PyTuple_New(2);
-    if (!paramsP)
+    resultP = PyResponseNew(item->status, item->nreplies, item->replies);
+    GlueCallManyUnref(many);
+    return resultP;
+
+OnErrorExit:
+    afb_data_array_unref((unsigned)params_count, params.data);
+    GlueDataArrayRelease(&params);
+    if (many)
+        GlueCallManyUnref(many);
+    if (reportError) {
+        GLUE_DBG_ERROR(afbMain, errorMsg);
+        PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    }
+    return NULL;
+}
+
+static PyObject*
+GlueCallSync(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: callsync(handle, api, verb, ...)";
+    long count = nargs;
+    if (count < 1)
         goto OnErrorExit;
 
-    if (PyTuple_SetItem(paramsP, 0, PyLong_FromLong(status)) < 0)
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue)
+        goto OnErrorExit;
+
+    return GlueCallSyncArgs(
+      glue, argsP + 1, count - 1, 1);
+
+OnErrorExit:
+    GLUE_DBG_ERROR(afbMain, errorMsg);
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+// callmany(handle, [(api, verb, ...), ...], timeout) launches every subcall
+// in one native pass and waits for all of them with the GIL released. It
+// returns one libafb.response per call, in request order; calls still
+// running at timeout get AFB_ERRNO_NO_REPLY.
+static PyObject*
+GlueCallMany(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    bool reportError = true;
+    const char* errorMsg =
+      "syntax: callmany(handle, [(api, verb, ...), ...], timeout)";
+    GlueCallManyT* many = NULL;
+    GlueDataArrayT params = { 0 };
+    PyObject* listP = NULL;
+    PyObject* resultP = NULL;
+    Py_ssize_t count, total = 0, converted = 0;
+    int timeout;
+
+    if (nargs != 3)
         goto OnErrorExit;
 
-    replyP = PyTuple_New(nreplies);
-    if (!replyP)
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue || (glue->magic != GLUE_RQT_MAGIC_TAG && !GlueGetApi(glue)))
         goto OnErrorExit;
-    if (PyTuple_SetItem(paramsP, 1, replyP) < 0)
+
+    timeout = (int)PyLong_AsLong(argsP[2]);
+    if (timeout <= 0)
         goto OnErrorExit;
-    replyP = NULL;
 
-    errorMsg =
-      PyPushAfbReply(PyTuple_GetItem(paramsP, 1), 0, nreplies, replies);
-    _unref_afb_params(replies, nreplies);
-    if (errorMsg)
+    listP = PySequence_Fast(argsP[1], errorMsg);
+    if (!listP)
+        return NULL;
+    count = PySequence_Fast_GET_SIZE(listP);
+    if (count == 0) {
+        Py_DECREF(listP);
+        return PyList_New(0);
+    }
+
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        PyObject* itemP = PySequence_Fast_GET_ITEM(listP, idx);
+        if (!PyTuple_Check(itemP) || PyTuple_GET_SIZE(itemP) < 2)
+            goto OnErrorExit;
+        total += PyTuple_GET_SIZE(itemP) - 2;
+    }
+
+    many = GlueCallManyNew(glue, (size_t)count);
+    if (!many || !GlueDataArrayInit(&params, (size_t)total)) {
+        errorMsg = "out of memory";
         goto OnErrorExit;
+    }
+
+    // convert every argument before launching anything
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        PyObject* itemP = PySequence_Fast_GET_ITEM(listP, idx);
+        GlueCallItemT* item = &many->items[idx];
+        item->api = PyUnicode_AsUTF8(PyTuple_GET_ITEM(itemP, 0));
+        item->verb = PyUnicode_AsUTF8(PyTuple_GET_ITEM(itemP, 1));
+        if (!item->api || !item->verb)
+            goto OnErrorExit;
+        item->params = params.data + converted;
+        for (Py_ssize_t jdx = 2; jdx < PyTuple_GET_SIZE(itemP); jdx++) {
+            if (!_convert_py_argument_to_afb_data(PyTuple_GET_ITEM(itemP, jdx),
+                                                  &params.data[converted],
+                                                  (int)jdx)) {
+                reportError = false;
+                goto OnErrorExit;
+            }
+            converted++;
+            item->nparams++;
+        }
+    }
 
-    resultP = PyObject_CallObject((PyObject*)&PyResponseType, paramsP);
-    Py_DECREF(paramsP);
+    // launched params are handed to libafb
+    if (GlueCallManyWait(many, timeout))
+        converted = 0;
+    afb_data_array_unref((unsigned)converted, params.data);
+    GlueDataArrayRelease(&params);
+    Py_DECREF(listP);
+
+    resultP = PyList_New(count);
+    for (Py_ssize_t idx = 0; resultP && idx < count; idx++) {
+        GlueCallItemT* item = &many->items[idx];
+        PyObject* responseP =
+          item->done
+            ? PyResponseNew(item->status, item->nreplies, item->replies)
+            : PyResponseNew(AFB_ERRNO_NO_REPLY, 0, NULL);
+        if (!responseP)
+            Py_CLEAR(resultP);
+        else
+            PyList_SET_ITEM(resultP, idx, responseP);
+    }
+    GlueCallManyUnref(many);
     return resultP;
 
 OnErrorExit:
-    if (!params_handed_to_libafb)
-        afb_data_array_unref((unsigned)params_count, params);
-    afb_data_array_unref(nreplies, replies);
-    Py_XDECREF(replyP);
-    Py_XDECREF(paramsP);
+    afb_data_array_unref((unsigned)converted, params.data);
+    GlueDataArrayRelease(&params);
+    if (many)
+        GlueCallManyUnref(many);
+    Py_XDECREF(listP);
     if (reportError) {
         GLUE_DBG_ERROR(afbMain, errorMsg);
         PyErr_SetString(PyExc_RuntimeError, errorMsg);
@@ -857,45 +1103,154 @@ OnErrorExit:
     return NULL;
 }
 
+// ------------------------------------------------------------
+// libafb.Request: python object wrapping a request glue handle
+// ------------------------------------------------------------
+#define GLUE_RQT_FREELIST_MAX 64
+
+typedef struct
+{
+    PyObject_HEAD GlueHandleT* glue;
+} PyRequestObjectT;
+
+// recycled request objects, protected by the GIL or per thread when the
+// interpreter runs without it
+static GLUE_NOGIL_LOCAL PyRequestObjectT* rqtFreeList[GLUE_RQT_FREELIST_MAX];
+static GLUE_NOGIL_LOCAL int rqtFreeCount = 0;
+
+static PyTypeObject PyRequestType;
+
+static void
+PyRequestFreeCb(PyObject* self)
+{
+    PyRequestObjectT* rqtP = (PyRequestObjectT*)self;
+    GlueHandleT* glue = rqtP->glue;
+
+    rqtP->glue = NULL;
+    if (rqtFreeCount < GLUE_RQT_FREELIST_MAX)
+        rqtFreeList[rqtFreeCount++] = rqtP;
+    else
+        Py_TYPE(self)->tp_free(self);
+
+    // may release the request and its glue handle
+    afb_req_unref(glue->rqt.afb);
+}
+
+// return a libafb.Request holding a reference on the afb request
+PyObject*
+PyRqtObjectNew(GlueHandleT* glue)
+{
+    PyRequestObjectT* rqtP;
+
+    assert(glue->magic == GLUE_RQT_MAGIC_TAG);
+    if (rqtFreeCount > 0) {
+        rqtP = rqtFreeList[--rqtFreeCount];
+        PyObject_Init((PyObject*)rqtP, &PyRequestType);
+    } else {
+        rqtP = PyObject_New(PyRequestObjectT, &PyRequestType);
+        if (!rqtP)
+            return NULL;
+    }
+    afb_req_addref(glue->rqt.afb);
+    rqtP->glue = glue;
+    return (PyObject*)rqtP;
+}
+
+// return the glue handle hidden behind a libafb.Request or an opaque capsule
+GlueHandleT*
+PyGlueHandleGet(PyObject* handleP)
+{
+    if (!handleP)
+        return NULL;
+    if (Py_TYPE(handleP) == &PyRequestType)
+        return ((PyRequestObjectT*)handleP)->glue;
+    if (PyCapsule_IsValid(handleP, GLUE_AFB_UID))
+        return PyCapsule_GetPointer(handleP, GLUE_AFB_UID);
+    return NULL;
+}
+
+// wrap a glue handle before handing it to a python callback
+PyObject*
+PyGlueHandleNew(GlueHandleT* glue)
+{
+    if (glue->magic == GLUE_RQT_MAGIC_TAG)
+        return PyRqtObjectNew(glue);
+
+    GLUE_USAGE_INC(glue);
+    return PyCapsule_New(glue, GLUE_AFB_UID, GlueFreeCapsuleCb);
+}
+
+static PyObject*
+PyRequestReply(PyObject* self, PyObject* const* argsP, Py_ssize_t count)
+{
+    return GlueReplyArgs(((PyRequestObjectT*)self)->glue, argsP, count);
+}
+
 static PyObject*
-GlueEvtPush(PyObject* self, PyObject* argsP)
+PyRequestSubcall(PyObject* self, PyObject* const* argsP, Py_ssize_t count)
+{
+    return GlueCallSyncArgs(((PyRequestObjectT*)self)->glue, argsP, count, 0);
+}
+
+static PyMethodDef PyRequestMethods[] = {
+    { "reply",
+      GLUE_FASTCALL(PyRequestReply),
+      "reply(status, [arg1 ... argn]) explicit response to the request" },
+    { "subcall",
+      GLUE_FASTCALL(PyRequestSubcall),
+      "subcall(api, verb, ...) synchronous subcall, returns libafb.response" },
+    { NULL } /* sentinel */
+};
+
+static PyTypeObject PyRequestType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "libafb.Request",
+    .tp_doc = "AFB request object",
+    .tp_basicsize = sizeof(PyRequestObjectT),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = PyRequestFreeCb,
+    .tp_methods = PyRequestMethods,
+};
+
+static PyObject*
+GlueEvtPush(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: eventpush(evtid, [arg1...argn])";
-    long count = PyTuple_GET_SIZE(argsP);
-    afb_data_t params[count];
+    long count = nargs;
     long index = 0;
     long params_count = 0;
-    memset(params, 0, sizeof(params));
+    GlueDataArrayT paramsA;
+    afb_data_t* params = GlueDataArrayInit(&paramsA, (size_t)count);
+    if (!params)
+        return PyErr_NoMemory();
 
     if (count < 1)
         goto OnErrorExit;
     afb_event_t evtid =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+      PyCapsule_GetPointer(argsP[0], GLUE_AFB_UID);
     if (!evtid || !afb_event_is_valid(evtid))
         goto OnErrorExit;
 
-    // get response from PY and push them as afb-v4 object
+    // event data keep their native afb type, as with evtpushmany
     for (index = 0; index < count - 1; index++) {
-        int hasError = 0;
-        json_object* argsJ =
-          pyObjToJson(PyTuple_GetItem(argsP, index + 1), &hasError);
-        if (hasError) {
+        if (!_convert_py_argument_to_afb_data(
+              argsP[index + 1], &params[index], (int)index + 1)) {
             errorMsg = "invalid argument type";
             goto OnErrorExit;
         }
-        afb_create_data_raw(&params[index],
-                            AFB_PREDEFINED_TYPE_JSON_C,
-                            argsJ,
-                            0,
-                            (void*)json_object_put,
-                            argsJ);
+        params_count = index + 1;
     }
-    params_count = index;
 
     int status;
-    Py_BEGIN_ALLOW_THREADS status = afb_event_push(evtid, (int)index, params);
+    GlueEvtPolicyT* policy = PyCapsule_GetContext(argsP[0]);
+    Py_BEGIN_ALLOW_THREADS status =
+      policy ? GlueEvtPolicyPush(policy, (unsigned)index, params)
+             : afb_event_push(evtid, (int)index, params);
     Py_END_ALLOW_THREADS
 
+    // pushed data are consumed, even on failure
+    params_count = 0;
+    GlueDataArrayRelease(&paramsA);
     if (status < 0) {
         errorMsg = "afb_event_push fail sending event";
         goto OnErrorExit;
@@ -904,27 +1259,159 @@ GlueEvtPush(PyObject* self, PyObject* argsP)
 
 OnErrorExit:
     afb_data_array_unref((unsigned)params_count, params);
+    GlueDataArrayRelease(&paramsA);
     GLUE_DBG_ERROR(afbMain, errorMsg);
-    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    if (!PyErr_Occurred())
+        PyErr_SetString(PyExc_RuntimeError, errorMsg);
     return NULL;
 }
 
+// one event push prepared by evtpushmany
+typedef struct
+{
+    afb_event_t evtid;
+    GlueEvtPolicyT* policy;
+    unsigned offset;
+    unsigned count;
+    int status;
+} GluePushItemT;
+
+// evtpushmany(evtid, [(arg1..argn), ...]) or evtpushmany([(evtid, arg1..argn),
+// ...]). All payloads are converted first, then pushed in a single native
+// loop with the GIL released. Returns the afb status of each push.
 static PyObject*
-GlueEvtSubscribe(PyObject* self, PyObject* argsP)
+GlueEvtPushMany(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg =
+      "syntax: evtpushmany(evtid, payloads) or evtpushmany(pushes)";
+    GluePushItemT* items = NULL;
+    afb_data_t* params = NULL;
+    PyObject* seqP = NULL;
+    PyObject* resultP = NULL;
+    afb_event_t evtid = NULL;
+    Py_ssize_t count, total = 0, converted = 0;
+    int first = 0;
+
+    if (nargs == 2) {
+        evtid = PyCapsule_GetPointer(argsP[0], GLUE_AFB_UID);
+        if (!evtid || !afb_event_is_valid(evtid))
+            goto OnErrorExit;
+    } else if (nargs != 1) {
+        goto OnErrorExit;
+    } else {
+        first = 1; // each push starts with its event
+    }
+
+    seqP = PySequence_Fast(argsP[nargs - 1], "payloads should be iterable");
+    if (!seqP)
+        goto OnErrorExit;
+    count = PySequence_Fast_GET_SIZE(seqP);
+
+    // size the flat data vector, non tuple payloads are single argument
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        PyObject* pushP = PySequence_Fast_GET_ITEM(seqP, idx);
+        if (PyTuple_Check(pushP))
+            total += PyTuple_GET_SIZE(pushP) - first;
+        else if (first)
+            goto OnErrorExit;
+        else
+            total++;
+    }
+
+    items = calloc((size_t)count + 1, sizeof(GluePushItemT));
+    params = calloc((size_t)total + 1, sizeof(afb_data_t));
+    if (!items || !params) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        PyObject* pushP = PySequence_Fast_GET_ITEM(seqP, idx);
+        PyObject* const* pushArgs = &pushP;
+        Py_ssize_t pushCount = 1;
+
+        if (PyTuple_Check(pushP)) {
+            pushArgs = PySequence_Fast_ITEMS(pushP);
+            pushCount = PyTuple_GET_SIZE(pushP);
+        }
+
+        items[idx].evtid = evtid;
+        items[idx].policy = evtid ? PyCapsule_GetContext(argsP[0]) : NULL;
+        if (first) {
+            if (pushCount < 1)
+                goto OnErrorExit;
+            items[idx].evtid = PyCapsule_GetPointer(pushArgs[0], GLUE_AFB_UID);
+            if (!items[idx].evtid || !afb_event_is_valid(items[idx].evtid)) {
+                errorMsg = "evtpushmany: invalid event handle";
+                goto OnErrorExit;
+            }
+            items[idx].policy = PyCapsule_GetContext(pushArgs[0]);
+        }
+
+        items[idx].offset = (unsigned)converted;
+        for (Py_ssize_t jdx = first; jdx < pushCount; jdx++) {
+            if (!_convert_py_argument_to_afb_data(
+                  pushArgs[jdx], &params[converted], (int)jdx)) {
+                errorMsg = "evtpushmany: invalid argument type";
+                goto OnErrorExit;
+            }
+            converted++;
+        }
+        items[idx].count = (unsigned)converted - items[idx].offset;
+    }
+
+    // afb_event_push takes ownership of data whatever its status
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        afb_data_t* pushParams = &params[items[idx].offset];
+        items[idx].status =
+          items[idx].policy
+            ? GlueEvtPolicyPush(items[idx].policy, items[idx].count, pushParams)
+            : afb_event_push(items[idx].evtid, items[idx].count, pushParams);
+    }
+    Py_END_ALLOW_THREADS
+
+    resultP = PyList_New(count);
+    for (Py_ssize_t idx = 0; resultP && idx < count; idx++) {
+        PyObject* statusP = PyLong_FromLong(items[idx].status);
+        if (!statusP) {
+            Py_CLEAR(resultP);
+            break;
+        }
+        PyList_SET_ITEM(resultP, idx, statusP);
+    }
+    free(items);
+    free(params);
+    Py_DECREF(seqP);
+    return resultP;
+
+OnErrorExit:
+    if (params)
+        afb_data_array_unref((unsigned)converted, params);
+    free(items);
+    free(params);
+    Py_XDECREF(seqP);
+    GLUE_DBG_ERROR(afbMain, errorMsg);
+    if (!PyErr_Occurred())
+        PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+static PyObject*
+GlueEvtSubscribe(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: subscribe(rqt,evtid)";
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_RQT_MAGIC_TAG)
         goto OnErrorExit;
 
     afb_event_t evtid =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 1), GLUE_AFB_UID);
+      PyCapsule_GetPointer(argsP[1], GLUE_AFB_UID);
     if (!evtid || !afb_event_is_valid(evtid))
         goto OnErrorExit;
 
@@ -942,21 +1429,20 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueEvtUnsubscribe(PyObject* self, PyObject* argsP)
+GlueEvtUnsubscribe(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: unsubscribe(rqt,evtid)";
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_RQT_MAGIC_TAG)
         goto OnErrorExit;
 
     afb_event_t evtid =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 1), GLUE_AFB_UID);
+      PyCapsule_GetPointer(argsP[1], GLUE_AFB_UID);
     if (!evtid || !afb_event_is_valid(evtid))
         goto OnErrorExit;
 
@@ -974,22 +1460,57 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueEvtNew(PyObject* self, PyObject* argsP)
+GlueEvtNew(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    const char* errorMsg = "syntax: evtid= eventnew(api,label)";
+    const char* errorMsg = "syntax: evtid= eventnew(api,label,[policy])";
+    GlueEvtPolicyT* policy = NULL;
+    PyObject* capsuleP;
     afb_event_t evtid;
     int err;
 
-    long count = PyTuple_GET_SIZE(argsP);
-    if (count != 2)
+    long count = nargs;
+    if (count < 2 || count > 3)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    // optional publishing policy {'coalesce': ms} or {'rate': push/s}
+    if (count == 3 && argsP[2] != Py_None) {
+        PyObject* coalesceP = NULL;
+        PyObject* rateP = NULL;
+        long value;
+
+        if (PyDict_Check(argsP[2])) {
+            coalesceP = PyDict_GetItemString(argsP[2], "coalesce");
+            rateP = PyDict_GetItemString(argsP[2], "rate");
+        }
+        if (!coalesceP == !rateP) {
+            errorMsg = "evtnew policy should be {'coalesce':ms} or {'rate':n}";
+            goto OnErrorExit;
+        }
+        value = PyLong_Check(coalesceP ? coalesceP : rateP)
+                  ? PyLong_AsLong(coalesceP ? coalesceP : rateP)
+                  : 0;
+        if (value <= 0 || (rateP && value > 1000)) {
+            errorMsg = "evtnew policy coalesce>0 (ms) or rate=[1-1000] (/s)";
+            goto OnErrorExit;
+        }
+
+        policy = calloc(1, sizeof(GlueEvtPolicyT));
+        if (!policy) {
+            errorMsg = "out of memory";
+            goto OnErrorExit;
+        }
+        pthread_mutex_init(&policy->mutex, NULL);
+        policy->leading = rateP != NULL;
+        // round the rate period up so the rate is never exceeded
+        policy->period =
+          (unsigned)(rateP ? (1000 + value - 1) / value : value);
+    }
+
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || !GlueGetApi(glue))
         goto OnErrorExit;
 
-    char* label = pyObjToStr(PyTuple_GetItem(argsP, 1));
+    char* label = pyObjToStr(argsP[1]);
     if (!label)
         goto OnErrorExit;
 
@@ -1000,35 +1521,46 @@ GlueEvtNew(PyObject* self, PyObject* argsP)
         goto OnErrorExit;
     }
 
-    // push event afb handle as a PY opaque handle
-    return PyCapsule_New(evtid, GLUE_AFB_UID, NULL);
+    // push event afb handle as a PY opaque handle, with its policy as context.
+    // As the event itself, the policy lives until the binder exits.
+    capsuleP = PyCapsule_New(evtid, GLUE_AFB_UID, NULL);
+    if (capsuleP && policy) {
+        policy->evtid = evtid;
+        PyCapsule_SetContext(capsuleP, policy);
+    }
+    return capsuleP;
 
 OnErrorExit:
+    free(policy);
     GLUE_DBG_ERROR(afbMain, errorMsg);
     PyErr_SetString(PyExc_RuntimeError, errorMsg);
     return NULL;
 }
 
 static PyObject*
-GlueVerbAdd(PyObject* self, PyObject* argsP)
+GlueVerbAdd(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: addverb(api, config, context)";
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 3)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_API_MAGIC_TAG)
         goto OnErrorExit;
 
     int hasError = 0;
-    json_object* configJ = pyObjToJson(PyTuple_GetItem(argsP, 1), &hasError);
+    json_object* configJ = pyObjToJson(argsP[1], &hasError);
     if (hasError)
         goto OnErrorExit;
 
-    PyObject* userdataP = PyTuple_GetItem(argsP, 2);
+    // record is attached before the verb can be requested
+    errorMsg = GlueVerbPrepare(glue, configJ);
+    if (errorMsg)
+        goto OnErrorExit;
+
+    PyObject* userdataP = argsP[2];
     if (userdataP)
         Py_IncRef(userdataP);
 
@@ -1037,6 +1569,11 @@ GlueVerbAdd(PyObject* self, PyObject* argsP)
     if (errorMsg)
         goto OnErrorExit;
 
+    errorMsg = GlueVerbsCompile(glue->api.afb);
+    if (errorMsg)
+        goto OnErrorExit;
+    GlueInfoInvalidate(glue);
+
     Py_RETURN_NONE;
 
 OnErrorExit:
@@ -1046,19 +1583,18 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueSetLoa(PyObject* self, PyObject* argsP)
+GlueSetLoa(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: setloa(rqt, newloa)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue && glue->magic != GLUE_RQT_MAGIC_TAG)
         goto OnErrorExit;
 
-    int loa = (int)PyLong_AsLong(PyTuple_GetItem(argsP, 1));
+    int loa = (int)PyLong_AsLong(argsP[1]);
     if (loa < 0)
         goto OnErrorExit;
 
@@ -1077,21 +1613,21 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueTimerAddref(PyObject* self, PyObject* argsP)
+GlueTimerAddref(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: timeraddref(handle)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 1)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_TIMER_MAGIC_TAG)
         goto OnErrorExit;
 
-    afb_timer_addref(glue->timer.afb);
+    if (!glue->timer.wheel)
+        afb_timer_addref(glue->timer.afb);
     Py_IncRef(glue->timer.configP);
-    glue->usage++;
+    GLUE_USAGE_INC(glue);
     Py_RETURN_NONE;
 
 OnErrorExit:
@@ -1101,15 +1637,14 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueTimerUnref(PyObject* self, PyObject* argsP)
+GlueTimerUnref(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: timerunref(handle)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 1)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_TIMER_MAGIC_TAG)
         goto OnErrorExit;
 
@@ -1122,17 +1657,42 @@ OnErrorExit:
     return NULL;
 }
 
+// return run count, drift and jitter histograms of a wheel timer
+static PyObject*
+GlueTimerStats(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: timerstats(handle)";
+    if (nargs != 1)
+        goto OnErrorExit;
+
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue || glue->magic != GLUE_TIMER_MAGIC_TAG)
+        goto OnErrorExit;
+    if (!glue->timer.wheel) {
+        errorMsg = "timerstats: timer not created with 'wheel' option";
+        goto OnErrorExit;
+    }
+
+    json_object* statsJ = GlueWheelStatsJson(glue->timer.wheel);
+    PyObject* statsP = jsonToPyObj(statsJ);
+    json_object_put(statsJ);
+    return statsP;
+
+OnErrorExit:
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
 static PyObject*
-GlueEvtHandler(PyObject* self, PyObject* argsP)
+GlueEvtHandler(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: evthandler(handle, "
                            "{'pattern':'yyy','callback':'zzz'}, userdata)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count < 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
@@ -1147,7 +1707,7 @@ GlueEvtHandler(PyObject* self, PyObject* argsP)
     handle->magic = GLUE_EVT_MAGIC_TAG;
     handle->event.apiv4 = apiv4;
 
-    PyObject* configP = PyTuple_GetItem(argsP, 1);
+    PyObject* configP = argsP[1];
     if (!PyDict_Check(configP))
         goto OnErrorExit;
 
@@ -1165,13 +1725,35 @@ GlueEvtHandler(PyObject* self, PyObject* argsP)
     Py_IncRef(handle->event.async.callbackP);
 
     handle->event.async.userdataP =
-      (count < 3) ? NULL : PyTuple_GetItem(argsP, 2);
+      (count < 3) ? NULL : argsP[2];
     if (handle->event.async.userdataP == Py_None)
         handle->event.async.userdataP = NULL;
     if (handle->event.async.userdataP)
         Py_IncRef(handle->event.async.userdataP);
 
-    errorMsg = AfbAddOneEvent(apiv4, NULL, pattern, GlueEventCb, handle);
+    // every python pattern of the api shares the api dispatcher
+    GlueEvtDispatchT* dispatch = GlueEvtDispatchGet(apiv4, 1);
+    if (!dispatch) {
+        free(pattern);
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+
+    GlueEvtDispatchLock(dispatch);
+    if (GlueEvtDispatchFind(dispatch, pattern)) {
+        errorMsg = "event handler already exists";
+    } else {
+        errorMsg =
+          AfbAddOneEvent(apiv4, NULL, pattern, GlueEvtDispatchCb, dispatch);
+    }
+    if (!errorMsg) {
+        errorMsg = GlueEvtDispatchAdd(dispatch, pattern, handle);
+        if (errorMsg) {
+            void* userdata;
+            AfbDelOneEvent(apiv4, pattern, &userdata);
+        }
+    }
+    GlueEvtDispatchUnlock(dispatch);
     free(pattern);
     if (errorMsg)
         goto OnErrorExit;
@@ -1185,23 +1767,22 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueEvtDelete(PyObject* self, PyObject* argsP)
+GlueEvtDelete(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: evtdelete(handle, pattern: str)";
     void* userdata;
     char* pattern = NULL;
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
     afb_api_t apiv4 = GlueGetApi(glue);
     if (!apiv4)
         goto OnErrorExit;
-    PyObject* patternP = PyTuple_GetItem(argsP, 1);
+    PyObject* patternP = argsP[1];
     if (!patternP || !PyUnicode_Check(patternP))
         goto OnErrorExit;
 
@@ -1212,13 +1793,16 @@ GlueEvtDelete(PyObject* self, PyObject* argsP)
     }
 
     errorMsg = AfbDelOneEvent(apiv4, pattern, &userdata);
-    free(pattern);
-    pattern = NULL;
     if (errorMsg)
         goto OnErrorExit;
-    GlueHandleT* handle = (GlueHandleT*)userdata;
-    assert(handle->magic == GLUE_EVT_MAGIC_TAG);
-    GlueFreeHandleCb(handle);
+    // the dispatcher releases the handle, once running handlers returned
+    GlueEvtDispatchLock(userdata);
+    int status = GlueEvtDispatchDel(userdata, pattern);
+    GlueEvtDispatchUnlock(userdata);
+    free(pattern);
+    pattern = NULL;
+    assert(status == 0);
+    (void)status;
 
     Py_RETURN_NONE;
 
@@ -1230,11 +1814,13 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueTimerNew(PyObject* self, PyObject* argsP)
+GlueTimerNew(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: timernew(api, config, context)";
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    if (nargs != 3)
+        goto OnErrorExit;
+
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
@@ -1242,12 +1828,12 @@ GlueTimerNew(PyObject* self, PyObject* argsP)
     if (handle == NULL)
         goto OnErrorExit;
     handle->magic = GLUE_TIMER_MAGIC_TAG;
-    handle->timer.configP = PyTuple_GetItem(argsP, 1);
+    handle->timer.configP = argsP[1];
     if (!PyDict_Check(handle->timer.configP))
         goto OnErrorExit;
     Py_IncRef(handle->timer.configP);
 
-    handle->timer.async.userdataP = PyTuple_GetItem(argsP, 2);
+    handle->timer.async.userdataP = argsP[2];
     if (handle->timer.async.userdataP == Py_None)
         handle->timer.async.userdataP = NULL;
     else
@@ -1284,9 +1870,32 @@ GlueTimerNew(PyObject* self, PyObject* argsP)
     if (!slotP || !PyLong_Check(slotP))
         goto OnErrorExit;
     long count = PyLong_AsLong(slotP);
-    if (period < 0)
+    if (count < 0)
         goto OnErrorExit;
 
+    // optional timer wheel tick, True for the default one
+    slotP = PyDict_GetItemString(handle->timer.configP, "wheel");
+    if (slotP && slotP != Py_False && slotP != Py_None) {
+        long tick = GLUE_WHEEL_TICK_MS;
+        errorMsg = "timerconfig 'wheel' should be True or a tick(ms) > 0";
+        if (slotP != Py_True) {
+            if (!PyLong_Check(slotP))
+                goto OnErrorExit;
+            tick = PyLong_AsLong(slotP);
+            if (tick <= 0)
+                goto OnErrorExit;
+        }
+        handle->timer.wheel = GlueWheelAdd(handle,
+                                           (unsigned)tick,
+                                           (unsigned long)period,
+                                           (unsigned long)count);
+        if (!handle->timer.wheel) {
+            errorMsg = "(hoops) timer wheel creation fail";
+            goto OnErrorExit;
+        }
+        return PyCapsule_New(handle, GLUE_AFB_UID, NULL);
+    }
+
     int err = afb_timer_create(&handle->timer.afb,
                                0,
                                0,
@@ -1311,14 +1920,14 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueJobAbort(PyObject* self, PyObject* argsP)
+GlueJobAbort(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     const char* errorMsg = "syntax: jobabort(jobid)";
     if (count != 1)
         goto OnErrorExit;
 
-    long jobid = PyLong_AsLong(PyTuple_GetItem(argsP, 0));
+    long jobid = PyLong_AsLong(argsP[0]);
     if (jobid <= 0)
         goto OnErrorExit;
 
@@ -1334,22 +1943,21 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueJobPost(PyObject* self, PyObject* argsP)
+GlueJobPost(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "jobpost(binder, callback, delay, [userdata])";
     GlueCallHandleT* handle = NULL;
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count < 3)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
     // prepare handle for callback
-    handle = calloc(1, sizeof(GlueCallHandleT));
+    handle = GluePoolAlloc(GLUE_POOL_CALL);
     if (handle == NULL) {
         errorMsg = "out of memory";
         goto OnErrorExit;
@@ -1357,7 +1965,7 @@ GlueJobPost(PyObject* self, PyObject* argsP)
     handle->magic = GLUE_POST_MAGIC_TAG;
     handle->glue = glue;
 
-    handle->async.callbackP = PyTuple_GetItem(argsP, 1);
+    handle->async.callbackP = argsP[1];
     if (!PyCallable_Check(handle->async.callbackP)) {
         errorMsg = "syntax: callback should be a valid callable function";
         goto OnErrorExit;
@@ -1369,12 +1977,12 @@ GlueJobPost(PyObject* self, PyObject* argsP)
         handle->async.uid = pyObjToStr(uidP);
     /* PyDict_GetItemString() returns a borrowed reference. */
 
-    long delay = PyLong_AsLong(PyTuple_GetItem(argsP, 2));
+    long delay = PyLong_AsLong(argsP[2]);
     if (delay <= 0)
         goto OnErrorExit;
 
-    if (PyTuple_GET_SIZE(argsP) > 3) {
-        handle->async.userdataP = PyTuple_GetItem(argsP, 3);
+    if (nargs > 3) {
+        handle->async.userdataP = argsP[3];
         if (handle->async.userdataP == Py_None)
             handle->async.userdataP = NULL;
         else
@@ -1401,26 +2009,28 @@ OnErrorExit:
         Py_DecRef(handle->async.callbackP);
         if (handle->async.userdataP)
             Py_DecRef(handle->async.userdataP);
-        free(handle);
+        GluePoolFree(GLUE_POOL_CALL, handle);
     }
     return NULL;
 }
 
 // manual_lock means jobenter; !manual_lock means jobcall
 PyObject*
-GlueJob(PyObject* self, PyObject* argsP, bool manual_lock)
+GlueJob(PyObject* self,
+        PyObject* const* argsP,
+        Py_ssize_t nargs,
+        bool manual_lock)
 {
     const char* errorMsg = "jobcall(binder, callback, timeout, [userdata])";
     GlueHandleT* handle = NULL;
     int err;
 
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count < 3)
         goto OnErrorExit;
 
     // arg index 0: handle
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
@@ -1434,7 +2044,7 @@ GlueJob(PyObject* self, PyObject* argsP, bool manual_lock)
     handle->magic = GLUE_JOB_MAGIC_TAG;
     handle->job.apiv4 = GlueGetApi(glue);
     // get callback from Python
-    handle->job.async.callbackP = PyTuple_GetItem(argsP, 1);
+    handle->job.async.callbackP = argsP[1];
     if (!PyCallable_Check(handle->job.async.callbackP)) {
         errorMsg = "callback should be a valid callable";
         goto OnErrorExit;
@@ -1447,13 +2057,13 @@ GlueJob(PyObject* self, PyObject* argsP, bool manual_lock)
     /* PyDict_GetItemString() returns a borrowed reference. */
 
     // arg index 2: timeout
-    int timeout = (int)PyLong_AsLong(PyTuple_GetItem(argsP, 2));
+    int timeout = (int)PyLong_AsLong(argsP[2]);
     if (timeout <= 0)
         goto OnErrorExit;
 
     // arg index 3: userdata
-    if (PyTuple_GET_SIZE(argsP) > 3) {
-        handle->job.async.userdataP = PyTuple_GetItem(argsP, 3);
+    if (nargs > 3) {
+        handle->job.async.userdataP = argsP[3];
         if (handle->job.async.userdataP == Py_None)
             handle->job.async.userdataP = NULL;
         else
@@ -1486,31 +2096,30 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueJobCall(PyObject* self, PyObject* argsP)
+GlueJobCall(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    return GlueJob(self, argsP, false);
+    return GlueJob(self, argsP, nargs, false);
 }
 
 static PyObject*
-GlueJobEnter(PyObject* self, PyObject* argsP)
+GlueJobEnter(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    return GlueJob(self, argsP, true);
+    return GlueJob(self, argsP, nargs, true);
 }
 
 static PyObject*
-GlueJobLeave(PyObject* self, PyObject* argsP)
+GlueJobLeave(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     int err;
     const char* errorMsg = "syntax: jobleave(job, status)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit0;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_JOB_MAGIC_TAG)
         goto OnErrorExit0;
-    glue->job.status = PyLong_AsLong(PyTuple_GetItem(argsP, 1));
+    glue->job.status = PyLong_AsLong(argsP[1]);
 
     err = afb_sched_leave(glue->job.afb);
     if (err) {
@@ -1528,19 +2137,18 @@ OnErrorExit0:
 }
 
 static PyObject*
-GlueExit(PyObject* self, PyObject* argsP)
+GlueExit(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     const char* errorMsg = "syntax: exit(handle, status)";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 2)
         goto OnErrorExit;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue)
         goto OnErrorExit;
 
-    long exitCode = PyLong_AsLong(PyTuple_GetItem(argsP, 1));
+    long exitCode = PyLong_AsLong(argsP[1]);
 
     AfbBinderExit(afbMain->binder.afb, (int)exitCode);
     Py_RETURN_NONE;
@@ -1551,20 +2159,19 @@ OnErrorExit:
 }
 
 static PyObject*
-GlueClientInfo(PyObject* self, PyObject* argsP)
+GlueClientInfo(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     PyObject* resultP;
     const char* errorMsg = "syntax: clientinfo(rqt, ['key'])";
-    long count = PyTuple_GET_SIZE(argsP);
+    long count = nargs;
     if (count != 1 && count != 2)
         goto OnErrorExit0;
 
-    GlueHandleT* glue =
-      PyCapsule_GetPointer(PyTuple_GetItem(argsP, 0), GLUE_AFB_UID);
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
     if (!glue || glue->magic != GLUE_RQT_MAGIC_TAG)
         goto OnErrorExit0;
 
-    PyObject* keyP = PyTuple_GetItem(argsP, 1);
+    PyObject* keyP = (count > 1) ? argsP[1] : NULL;
     if (keyP && !PyUnicode_Check(keyP))
         goto OnErrorExit;
 
@@ -1595,103 +2202,216 @@ OnErrorExit0:
 }
 
 static PyObject*
-GluePingTest(PyObject* self, PyObject* argsP)
+GluePingTest(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
     static long count = 0;
     long tid = pthread_self();
-    fprintf(stderr, "GluePingTest count=%ld tid=%ld\n", count++, tid);
+    fprintf(stderr,
+            "GluePingTest count=%ld tid=%ld\n",
+            GLUE_COUNTER_INC(count),
+            tid);
     return PyLong_FromLong(tid);
 }
 
+static PyObject*
+GluePoolStatsGet(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    return GluePoolStats();
+}
+
+// stats([handle]): GIL wait/hold histograms per callback entry point, plus
+// per verb ones for the handle api
+static PyObject*
+GlueStats(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: stats([handle])";
+    afb_api_t apiv4 = NULL;
+
+    if (nargs > 1)
+        goto OnErrorExit;
+    if (nargs == 1 && argsP[0] != Py_None) {
+        GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+        if (!glue)
+            goto OnErrorExit;
+        apiv4 = GlueGetApi(glue);
+        if (!apiv4)
+            goto OnErrorExit;
+    }
+
+    json_object* statsJ = GlueStatsJson(apiv4);
+    PyObject* statsP = jsonToPyObj(statsJ);
+    json_object_put(statsJ);
+    return statsP;
+
+OnErrorExit:
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+// return key cache counters, optionally resizing the cache first
+static PyObject*
+GlueKeyCache(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: keycache([size])";
+
+    if (nargs > 1)
+        goto OnErrorExit;
+    if (nargs == 1) {
+        if (!PyLong_Check(argsP[0]))
+            goto OnErrorExit;
+        if (GlueKeyCacheSetSize(PyLong_AsLong(argsP[0])) < 0)
+            return NULL;
+    }
+    return GlueKeyCacheStats();
+
+OnErrorExit:
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+// enable asynchronous logging with given ring slots (0 disables), return
+// log pipeline counters
+static PyObject*
+GlueLogAsync(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: logasync([slots])";
+
+    if (nargs > 1)
+        goto OnErrorExit;
+    if (nargs == 1) {
+        if (!PyLong_Check(argsP[0]))
+            goto OnErrorExit;
+        if (GlueLogAsyncSet(PyLong_AsLong(argsP[0])) < 0)
+            return NULL;
+    }
+    return GlueLogAsyncStats();
+
+OnErrorExit:
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
+// return evthandler patterns hit counters of handle api
+static PyObject*
+GlueEvtStats(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    const char* errorMsg = "syntax: evtstats(handle)";
+
+    if (nargs != 1)
+        goto OnErrorExit;
+    GlueHandleT* glue = PyGlueHandleGet(argsP[0]);
+    if (!glue || !GlueGetApi(glue))
+        goto OnErrorExit;
+
+    return GlueEvtDispatchStats(GlueEvtDispatchGet(GlueGetApi(glue), 0));
+
+OnErrorExit:
+    PyErr_SetString(PyExc_RuntimeError, errorMsg);
+    return NULL;
+}
+
 static PyMethodDef MethodsDef[] = {
     { "error",
-      GluePrintError,
-      METH_VARARGS,
+      GLUE_FASTCALL_KW(GluePrintError),
       "print level AFB_SYSLOG_LEVEL_ERROR" },
     { "warning",
-      GluePrintWarning,
-      METH_VARARGS,
+      GLUE_FASTCALL_KW(GluePrintWarning),
       "print level AFB_SYSLOG_LEVEL_WARNING" },
     { "notice",
-      GluePrintNotice,
-      METH_VARARGS,
+      GLUE_FASTCALL_KW(GluePrintNotice),
       "print level AFB_SYSLOG_LEVEL_NOTICE" },
     { "info",
-      GluePrintInfo,
-      METH_VARARGS,
+      GLUE_FASTCALL_KW(GluePrintInfo),
       "print level AFB_SYSLOG_LEVEL_INFO" },
     { "debug",
-      GluePrintDebug,
-      METH_VARARGS,
+      GLUE_FASTCALL_KW(GluePrintDebug),
       "print level AFB_SYSLOG_LEVEL_DEBUG" },
-    { "ping", GluePingTest, METH_VARARGS, "Check afb-libpython is loaded" },
+    { "ping", GLUE_FASTCALL(GluePingTest), "Check afb-libpython is loaded" },
     { "binder",
-      GlueBinderConf,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueBinderConf),
       "Configure and create afbMain glue" },
     { "config",
-      GlueGetConfig,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueGetConfig),
       "Return glue handle full/partial config" },
-    { "apiadd", GlueApiAdd, METH_VARARGS, "Add a new API to the binder" },
+    { "apiadd", GLUE_FASTCALL(GlueApiAdd), "Add a new API to the binder" },
     { "apiimport",
-      GlueApiImport,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueApiImport),
       "Import a new API to the binder" },
     { "apicreate",
-      GlueApiCreate,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueApiCreate),
       "Create a new API to the binder" },
     { "loopstart",
-      GlueLoopStart,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueLoopStart),
       "Activate mainloop and exec startup callback" },
-    { "reply", GlueReply, METH_VARARGS, "Explicit response tp afb request" },
+    { "reply", GLUE_FASTCALL(GlueReply), "Explicit response tp afb request" },
     { "binding",
-      GlueBindingLoad,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueBindingLoad),
       "Load binding an expose corresponding api/verbs" },
-    { "callasync", GlueCallAsync, METH_VARARGS, "AFB asynchronous subcall" },
-    { "callsync", GlueCallSync, METH_VARARGS, "AFB synchronous subcall" },
-    { "verbadd", GlueVerbAdd, METH_VARARGS, "Add a verb to a non sealed API" },
-    { "evtsubscribe", GlueEvtSubscribe, METH_VARARGS, "Subscribe to event" },
+    { "call",
+      GLUE_FASTCALL(GlueCallAwait),
+      "Awaitable asynchronous AFB API call" },
+    { "aioloop",
+      GLUE_FASTCALL(GlueAioLoopGet),
+      "Return the asyncio loop bridged with the binder" },
+    { "aiorun",
+      GLUE_FASTCALL(GlueAioStart),
+      "Run a coroutine on the binder asyncio loop" },
+    { "callasync", GLUE_FASTCALL(GlueCallAsync), "AFB asynchronous subcall" },
+    { "callsync", GLUE_FASTCALL(GlueCallSync), "AFB synchronous subcall" },
+    { "callmany",
+      GLUE_FASTCALL(GlueCallMany),
+      "Batch of AFB subcalls waited on a single barrier" },
+    { "verbadd", GLUE_FASTCALL(GlueVerbAdd), "Add a verb to a non sealed API" },
+    { "evtsubscribe", GLUE_FASTCALL(GlueEvtSubscribe), "Subscribe to event" },
     { "evtunsubscribe",
-      GlueEvtUnsubscribe,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueEvtUnsubscribe),
       "Unsubscribe to event" },
     { "evthandler",
-      GlueEvtHandler,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueEvtHandler),
       "Register event callback handler" },
     { "evtdelete",
-      GlueEvtDelete,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueEvtDelete),
       "Delete event callback handler" },
-    { "evtnew", GlueEvtNew, METH_VARARGS, "Create a new event" },
-    { "evtpush", GlueEvtPush, METH_VARARGS, "Push a given event" },
-    { "timerunref", GlueTimerUnref, METH_VARARGS, "Unref existing timer" },
+    { "evtnew", GLUE_FASTCALL(GlueEvtNew), "Create a new event" },
+    { "evtpush", GLUE_FASTCALL(GlueEvtPush), "Push a given event" },
+    { "evtpushmany", GLUE_FASTCALL(GlueEvtPushMany), "Push a batch of events" },
+    { "evtstats",
+      GLUE_FASTCALL(GlueEvtStats),
+      "Return evthandler patterns hit counters" },
+    { "timerunref", GLUE_FASTCALL(GlueTimerUnref), "Unref existing timer" },
     { "timeraddref",
-      GlueTimerAddref,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueTimerAddref),
       "Addref to existing timer" },
-    { "timernew", GlueTimerNew, METH_VARARGS, "Create a new timer" },
-    { "setloa", GlueSetLoa, METH_VARARGS, "Set LOA (LevelOfAssurance)" },
+    { "timernew", GLUE_FASTCALL(GlueTimerNew), "Create a new timer" },
+    { "timerstats",
+      GLUE_FASTCALL(GlueTimerStats),
+      "Return wheel timer drift/jitter histograms" },
+    { "setloa", GLUE_FASTCALL(GlueSetLoa), "Set LOA (LevelOfAssurance)" },
     { "jobcall",
-      GlueJobCall,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueJobCall),
       "Synchronously call job in the current thread" },
     { "jobenter",
-      GlueJobEnter,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueJobEnter),
       "Register a mainloop waiting lock" },
-    { "jobleave", GlueJobLeave, METH_VARARGS, "Unlock jobenter" },
-    { "jobpost", GlueJobPost, METH_VARARGS, "Post a job after delay(ms)" },
-    { "jobabort", GlueJobAbort, METH_VARARGS, "Cancel a jobpost timer" },
+    { "jobleave", GLUE_FASTCALL(GlueJobLeave), "Unlock jobenter" },
+    { "jobpost", GLUE_FASTCALL(GlueJobPost), "Post a job after delay(ms)" },
+    { "jobabort", GLUE_FASTCALL(GlueJobAbort), "Cancel a jobpost timer" },
     { "clientinfo",
-      GlueClientInfo,
-      METH_VARARGS,
+      GLUE_FASTCALL(GlueClientInfo),
       "Return session info about client" },
-    { "exit", GlueExit, METH_VARARGS, "Exit binder with status" },
+    { "exit", GLUE_FASTCALL(GlueExit), "Exit binder with status" },
+    { "stats",
+      GLUE_FASTCALL(GlueStats),
+      "Return GIL wait/hold histograms, per verb for a given api" },
+    { "poolstats",
+      GLUE_FASTCALL(GluePoolStatsGet),
+      "Return request/call handle pools counters" },
+    { "keycache",
+      GLUE_FASTCALL(GlueKeyCache),
+      "Resize/return JSON key cache counters" },
+    { "logasync",
+      GLUE_FASTCALL(GlueLogAsync),
+      "Enable/return asynchronous log ring counters" },
 
     { NULL } /* sentinel */
 };
@@ -1724,6 +2444,42 @@ PyInit_libafb(void)
     if (status < 0)
         goto OnErrorExit;
 
+    status = PyType_Ready(&PyAfbDataType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    status = PyType_Ready(&PyJsonViewType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    Py_INCREF(&PyJsonViewType);
+    status = PyModule_AddObject(module, "JsonView", (PyObject*)&PyJsonViewType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    status = PyType_Ready(&PyLazyType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    Py_INCREF(&PyLazyType);
+    status = PyModule_AddObject(module, "lazy", (PyObject*)&PyLazyType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    status = PyType_Ready(&PyRequestType);
+    if (status < 0)
+        goto OnErrorExit;
+
+    Py_INCREF(&PyRequestType);
+    status = PyModule_AddObject(module, "Request", (PyObject*)&PyRequestType);
+    if (status < 0)
+        goto OnErrorExit;
+
+#ifdef Py_GIL_DISABLED
+    // glue shared state is atomic or guarded by GLUE_NOGIL_LOCK
+    PyUnstable_Module_SetGIL(module, Py_MOD_GIL_NOT_USED);
+#endif
+
     return module;
 
 OnErrorExit:
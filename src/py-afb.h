@@ -21,14 +21,35 @@
  * $RP_END_LICENSE$
  */
 #pragma once
+#include <pthread.h>
 #include <semaphore.h>
+#include <stdint.h>
 
 #include <json-c/json.h>
 #include <libafb-binder.h>
 #include <libafb/misc/afb-verbose.h>
 
 #define GLUE_AFB_UID "#afb#"
-#define SUBCALL_MAX_RPLY 8
+
+// counters and handle usage are shared by binder threads
+#define GLUE_COUNTER_INC(counter)                                              \
+    __atomic_fetch_add(&(counter), 1, __ATOMIC_RELAXED)
+#define GLUE_USAGE_INC(glue)                                                   \
+    __atomic_add_fetch(&(glue)->usage, 1, __ATOMIC_RELAXED)
+#define GLUE_USAGE_DEC(glue)                                                   \
+    __atomic_sub_fetch(&(glue)->usage, 1, __ATOMIC_ACQ_REL)
+
+// free-threaded builds (Py_GIL_DISABLED) have no GIL serializing the glue
+// shared state, GLUE_NOGIL_* guard it there and vanish on regular builds
+#ifdef Py_GIL_DISABLED
+#define GLUE_NOGIL_LOCK(mutex) PyMutex_Lock(&(mutex))
+#define GLUE_NOGIL_UNLOCK(mutex) PyMutex_Unlock(&(mutex))
+#define GLUE_NOGIL_LOCAL __thread
+#else
+#define GLUE_NOGIL_LOCK(mutex)
+#define GLUE_NOGIL_UNLOCK(mutex)
+#define GLUE_NOGIL_LOCAL
+#endif
 
 typedef enum
 {
@@ -41,6 +62,7 @@ typedef enum
     GLUE_JOB_MAGIC_TAG,         /**< Identify JOB objects */
     GLUE_POST_MAGIC_TAG,        /**< Identify POSTED JOB objects */
     GLUE_CALL_MAGIC_TAG,        /**< Identify ASYNCHRONOUS CALL objects */
+    GLUE_VERB_MAGIC_TAG,        /**< Identify VERB dispatch records */
 } GlueMagicTagE;
 
 typedef struct
@@ -72,13 +94,82 @@ typedef struct
     afb_api_t afb;
     PyObject *ctrlCb;
     PyObject *configP;
+    pthread_mutex_t infoMutex;
+    afb_data_t info;  /**< cached info verb reply, NULL when invalidated */
+    unsigned infoGen; /**< bumped by GlueInfoInvalidate */
 } PyApiHandleT;
 
+typedef enum
+{
+    GLUE_ENCODING_JSONC = 0, /**< Containers replied as json-c trees */
+    GLUE_ENCODING_JSON,      /**< Containers replied as JSON text */
+} GlueEncodingE;
+
+// lock-free log-linear histogram of durations in nanoseconds: each power of
+// two is split in 2^GLUE_HISTO_SUB_BITS linear sub-buckets, so a bucket is at
+// most 12.5% wide. Values up to 2^GLUE_HISTO_MAX_BITS ns (73 min) are kept
+// apart, larger ones share the last bucket.
+#define GLUE_HISTO_SUB_BITS 3
+#define GLUE_HISTO_MAX_BITS 42
+#define GLUE_HISTO_BUCKETS                                                     \
+    ((GLUE_HISTO_MAX_BITS - GLUE_HISTO_SUB_BITS + 1) << GLUE_HISTO_SUB_BITS)
+
+typedef struct
+{
+    unsigned long count;
+    unsigned long total;
+    unsigned long max;
+    unsigned long buckets[GLUE_HISTO_BUCKETS];
+} GlueHistoT;
+
+// callback entry points taking the GIL, see GlueGilEnsure
+typedef enum
+{
+    GLUE_GIL_VERB,     /**< verb requests */
+    GLUE_GIL_EVENT,    /**< event handlers */
+    GLUE_GIL_CONTROL,  /**< api control callbacks */
+    GLUE_GIL_STARTUP,  /**< mainloop startup callback */
+    GLUE_GIL_CALLBACK, /**< timer/job/subcall callbacks */
+    GLUE_GIL_FUTURE,   /**< libafb.call future resolution */
+    GLUE_GIL_RELEASE,  /**< python objects lent to afb data */
+    GLUE_GIL_TIMER,    /**< timer wheel ticks */
+    GLUE_GIL_COUNT
+} GlueGilPointE;
+
+typedef struct
+{
+    PyGILState_STATE state;
+    GlueGilPointE point;
+    uint64_t entered;
+    uint64_t acquired;
+} GlueGilT;
+
+// native dispatch record compiled once per verb at registration time
+typedef struct
+{
+    GlueMagicTagE magic;
+    const char *verb;
+    PyObject *callbackP;
+    GlueEncodingE encoding;
+    int jsonview;
+    unsigned long calls;
+    unsigned long errors;
+    GlueHistoT latency; /**< request arrival to reply */
+    GlueHistoT convert; /**< afb arguments to python */
+    GlueHistoT exec;    /**< python callback */
+    GlueHistoT encode;  /**< python reply to afb data */
+    GlueHistoT gilWait;
+    GlueHistoT gilHold;
+} GlueVerbT;
+
 typedef struct
 {
     struct PyApiHandleS *api;
     int replied;
     afb_req_t afb;
+    GlueVerbT *verb;
+    uint64_t arrival; /**< GlueNowNs() when the request reached the glue */
+    unsigned long logid; /**< asynchronous log request id, 0 until used */
 } PyRqtHandleT;
 
 typedef struct
@@ -95,6 +186,7 @@ typedef struct
     afb_api_t apiv4;
     PyObject *configP;
     GlueAsyncCtxT async;
+    struct GlueWheelTimerS *wheel; /**< NULL when owning its afb timer */
 } PyTimerHandleT;
 
 typedef struct
@@ -127,4 +219,128 @@ typedef struct
     GlueAsyncCtxT async;
 } GlueCallHandleT;
 
+// publishing policy attached to an event created with evtnew. Pushes within
+// a period are coalesced, the latest payload being pushed when it ends.
+typedef struct
+{
+    afb_event_t evtid;
+    pthread_mutex_t mutex;
+    unsigned period; /**< coalescing period in ms */
+    int leading;     /**< push immediately when no period is running */
+    int armed;       /**< a period timer is running */
+    int pending;     /**< a payload waits for the end of the period */
+    unsigned count;
+    afb_data_t *params;
+} GlueEvtPolicyT;
+
+// python event handler registered with evthandler
+typedef struct GlueEvtPatternS
+{
+    char *pattern;
+    size_t prefix;   /**< length of pattern literal prefix */
+    unsigned rank;   /**< registration order */
+    GlueHandleT *handle;
+    unsigned long hits;
+    int deleted;                     /**< removed while dispatching */
+    struct GlueEvtPatternS *next;    /**< dispatcher patterns list */
+    struct GlueEvtPatternS *sibling; /**< patterns sharing a trie node */
+} GlueEvtPatternT;
+
+// trie of pattern literal prefixes, a pattern hangs on its prefix last node
+typedef struct GlueEvtTrieS
+{
+    char key;
+    struct GlueEvtTrieS *child;
+    struct GlueEvtTrieS *sibling;
+    GlueEvtPatternT *patterns;
+} GlueEvtTrieT;
+
+// per api native dispatcher of python event handlers
+typedef struct GlueEvtDispatchS
+{
+    afb_api_t apiv4;
+    unsigned count;
+    unsigned ranks;
+    GlueEvtPatternT *patterns;
+    GlueEvtTrieT *trie;
+    unsigned dispatching;     /**< nested GlueEvtDispatchCb depth */
+    GlueEvtPatternT *zombies; /**< deleted while dispatching */
+    struct GlueEvtDispatchS *next;
+#ifdef Py_GIL_DISABLED
+    pthread_mutex_t mutex; /**< recursive, see GlueEvtDispatchLock */
+#endif
+} GlueEvtDispatchT;
+
+// one subcall of libafb.callmany
+typedef struct
+{
+    struct GlueCallManyS *many;
+    const char *api;
+    const char *verb;
+    unsigned nparams;
+    afb_data_t *params;
+    int done;
+    int status;
+    unsigned nreplies;
+    afb_data_t *replies;
+} GlueCallItemT;
+
+// completion barrier shared by callmany subcalls
+typedef struct GlueCallManyS
+{
+    pthread_mutex_t mutex;
+    struct afb_sched_lock *lock;
+    GlueHandleT *glue;
+    int launched;
+    int left;      /**< lock was left, by a completion or the timer */
+    int abandoned; /**< caller timed out, late replies are dropped */
+    int timeout;   /**< seconds, 0 waits forever */
+    unsigned usage;
+    unsigned pending;
+    unsigned count;
+    GlueCallItemT items[];
+} GlueCallManyT;
+
+// hierarchical timer wheel: python timers sharing a tick are run by a single
+// afb timer. Level 0 has one slot per tick, upper levels cascade down.
+#define GLUE_WHEEL_BITS0 8
+#define GLUE_WHEEL_BITSN 6
+#define GLUE_WHEEL_LEVELS 4
+#define GLUE_WHEEL_TICK_MS 10 // tick of 'wheel': True timers
+
+typedef struct GlueWheelTimerS
+{
+    struct GlueWheelTimerS *next;
+    struct GlueWheelTimerS **pprev; /**< NULL when not armed */
+    struct GlueWheelS *wheel;
+    GlueHandleT *glue;
+    uint64_t expires; /**< wheel tick */
+    uint64_t due;     /**< GlueNowNs() of next run */
+    uint64_t period;  /**< ns */
+    uint64_t lastRun;
+    unsigned long count; /**< runs to do, 0 forever */
+    unsigned long fired;
+    unsigned long missed; /**< runs skipped as wheel was late */
+    unsigned decount;
+    int busy;      /**< callback in progress */
+    int cancelled; /**< released while busy, freed by the wheel */
+    GlueHistoT drift;  /**< run time after due time */
+    GlueHistoT jitter; /**< run interval distance to period */
+} GlueWheelTimerT;
+
+typedef struct GlueWheelS
+{
+    struct GlueWheelS *next;
+    pthread_mutex_t mutex;
+    afb_timer_t afb; /**< NULL while no timer is armed */
+    unsigned tickms;
+    uint64_t tickns;
+    uint64_t base;  /**< GlueNowNs() of tick 0 */
+    uint64_t tick;  /**< next tick to run */
+    unsigned count; /**< armed timers */
+    int firing;
+    GlueWheelTimerT *tv0[1 << GLUE_WHEEL_BITS0];
+    GlueWheelTimerT *tvn[GLUE_WHEEL_LEVELS - 1][1 << GLUE_WHEEL_BITSN];
+} GlueWheelT;
+
 extern GlueHandleT *afbMain;
@@ -41,16 +41,27 @@
  * interpreter can correctly switch between threads.
  */
 
+static void
+GlueTimerClear(GlueHandleT* handle)
+{
+    Py_DecRef(handle->timer.async.callbackP);
+    if (handle->timer.async.userdataP)
+        Py_DecRef(handle->timer.async.userdataP);
+    free(handle->timer.async.uid);
+}
+
 void
 GlueFreeHandleCb(GlueHandleT* handle)
 {
+    int usage;
+
     if (!handle)
         goto OnErrorExit;
-    handle->usage--;
+    usage = GLUE_USAGE_DEC(handle);
 
     switch (handle->magic) {
         case GLUE_JOB_MAGIC_TAG:
-            if (handle->usage <= 0) {
+            if (usage <= 0) {
                 Py_DecRef(handle->job.async.callbackP);
                 if (handle->job.async.userdataP)
                     Py_DecRef(handle->job.async.userdataP);
@@ -58,13 +69,12 @@ GlueFreeHandleCb(GlueHandleT* handle)
             }
             break;
         case GLUE_TIMER_MAGIC_TAG:
-            afb_timer_unref(handle->timer.afb);
-            if (handle->usage <= 0) {
-                Py_DecRef(handle->timer.async.callbackP);
-                if (handle->timer.async.userdataP)
-                    Py_DecRef(handle->timer.async.userdataP);
-                free(handle->timer.async.uid);
-            }
+            if (!handle->timer.wheel)
+                afb_timer_unref(handle->timer.afb);
+            else if (usage <= 0 && GlueWheelCancel(handle->timer.wheel))
+                return; // released by GlueWheelCb once callback returns
+            if (usage <= 0)
+                GlueTimerClear(handle);
             break;
 
         case GLUE_EVT_MAGIC_TAG:
@@ -76,14 +86,16 @@ GlueFreeHandleCb(GlueHandleT* handle)
                                  // libafb
         case GLUE_RQT_MAGIC_TAG: // rqt live cycle is handle directly by libafb
         case GLUE_BINDER_MAGIC_TAG: // afbmain should never be released
-            handle->usage = 1;      // static handle
+            // static handle
+            __atomic_store_n(&handle->usage, 1, __ATOMIC_RELAXED);
+            usage = 1;
             break;
 
         default:
             goto OnErrorExit;
             return;
     }
-    if (handle->usage <= 0)
+    if (usage <= 0)
         free(handle);
     return;
 
@@ -98,13 +110,128 @@ GlueFreeCapsuleCb(PyObject* capsuleP)
     GlueFreeHandleCb(handle);
 }
 
+// reply a request with a verb result: (status, arg1..argn) or status
+static const char*
+GlueVerbReply(GlueHandleT* glue, GlueVerbT* verb, PyObject* resultP)
+{
+    PyObject* slotP;
+    long status, count;
+    GlueDataArrayT reply;
+
+    if (PyTuple_Check(resultP)) {
+        count = PyTuple_GET_SIZE(resultP);
+        slotP = PyTuple_GetItem(resultP, 0);
+        if (!slotP || !PyLong_Check(slotP))
+            return "Response 1st element should be status/integer";
+        status = PyLong_AsLong(slotP);
+        if (!GlueDataArrayInit(&reply, (size_t)count))
+            return "out of memory";
+        uint64_t encodeStart = GlueNowNs();
+        for (long idx = 0; idx < count - 1; idx++) {
+            slotP = PyTuple_GET_ITEM(resultP, idx + 1);
+            if (!GlueReplyConvert(
+                  slotP, &reply.data[idx], (int)idx + 1, verb->encoding)) {
+                afb_data_array_unref((unsigned)idx, reply.data);
+                GlueDataArrayRelease(&reply);
+                return "(hoops) unsupported response type";
+            }
+        }
+        GlueHistoAdd(&verb->encode, GlueNowNs() - encodeStart);
+
+        // respond request and free ressources.
+        GlueAfbReply(glue, status, count - 1, reply.data);
+        GlueDataArrayRelease(&reply);
+
+    } else if (PyLong_Check(resultP)) {
+        status = PyLong_AsLong(resultP);
+        GlueAfbReply(glue, status, 0, NULL);
+    }
+    return NULL;
+}
+
+// reply a request with an error and its python context
+static void
+GlueVerbError(GlueHandleT* glue, GlueVerbT* verb, const char* errorMsg)
+{
+    afb_data_t reply;
+    if (verb)
+        GLUE_COUNTER_INC(verb->errors);
+    json_object* errorJ = PyJsonDbg(errorMsg);
+    GLUE_AFB_WARNING(glue,
+                     "verb=[%s] python=%s",
+                     afb_req_get_called_verb(glue->rqt.afb),
+                     json_object_get_string(errorJ));
+    afb_create_data_raw(&reply,
+                        AFB_PREDEFINED_TYPE_JSON_C,
+                        errorJ,
+                        0,
+                        (void*)json_object_put,
+                        errorJ);
+    GlueAfbReply(glue, -1, 1, &reply);
+}
+
+// coroutine completion, self is the libafb.Request keeping the request alive
+static PyObject*
+GlueVerbDoneCb(PyObject* self, PyObject* futureP)
+{
+    GlueHandleT* glue = PyGlueHandleGet(self);
+    const char* errorMsg = "error during verb coroutine";
+
+    PyObject* resultP = PyObject_CallMethod(futureP, "result", NULL);
+    if (resultP) {
+        errorMsg = GlueVerbReply(glue, glue->rqt.verb, resultP);
+        Py_DECREF(resultP);
+    }
+    if (!resultP || errorMsg)
+        GlueVerbError(glue, glue->rqt.verb, errorMsg);
+    PyErr_Clear();
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef GlueVerbDoneDef = {
+    "_verbdone",
+    GlueVerbDoneCb,
+    METH_O,
+    "reply request with verb coroutine result",
+};
+
+// run a verb coroutine on the asyncio bridge loop, the request is replied
+// when it completes
+static const char*
+GlueVerbAwait(GlueHandleT* glue, PyObject* coroP)
+{
+    PyObject *futureP, *rqtP, *doneP = NULL, *statusP = NULL;
+
+    rqtP = PyRqtObjectNew(glue);
+    if (!rqtP)
+        return "out of memory";
+    doneP = PyCFunction_New(&GlueVerbDoneDef, rqtP);
+    Py_DECREF(rqtP);
+    if (!doneP)
+        return "out of memory";
+
+    futureP = GlueAioRun(coroP);
+    if (futureP) {
+        statusP =
+          PyObject_CallMethod(futureP, "add_done_callback", "O", doneP);
+        Py_DECREF(futureP);
+    }
+    Py_DECREF(doneP);
+    if (!statusP)
+        return "fail to schedule verb coroutine";
+    Py_DECREF(statusP);
+    return NULL;
+}
+
 void
 GlueApiVerbCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
 {
     const char* errorMsg = NULL;
-    int err;
+    GlueArgvT args = { .argv = NULL };
+    GlueVerbT* verb = NULL;
 
-    PyGILState_STATE gilState = PyGILState_Ensure();
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_VERB);
 
     // new afb request
     GlueHandleT* glue = PyRqtNew(afbRqt);
@@ -113,118 +240,76 @@ GlueApiVerbCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
         goto OnErrorExit;
     }
 
-    // on first call we compile configJ to boost following py api/verb calls
+    // dispatch record was compiled when the verb was registered, until
+    // apiadd returned it only hangs on the verb configJ
     AfbVcbDataT* vcbData = afb_req_get_vcbdata(afbRqt);
-    if (vcbData->magic != (void*)AfbAddVerbs) {
-        errorMsg = "(hoops) verb invalid vcbData handle";
+    verb = __atomic_load_n(&vcbData->callback, __ATOMIC_ACQUIRE);
+    if (!verb)
+        verb = json_object_get_userdata(vcbData->configJ);
+    if (!verb) {
+        errorMsg = "(hoops) verb has no dispatch record";
         goto OnErrorExit;
     }
+    assert(verb->magic == GLUE_VERB_MAGIC_TAG);
+    GLUE_COUNTER_INC(verb->calls);
+    glue->rqt.verb = verb;
+    glue->rqt.arrival = gil.entered;
 
-    // on first call we need to retreive original callback object from configJ
-    if (!vcbData->callback) {
-        json_object* callbackJ =
-          json_object_object_get(vcbData->configJ, "callback");
-        if (!callbackJ) {
-            errorMsg = "(hoops) verb no callback defined";
-            goto OnErrorExit;
-        }
-
-        // extract Python callable from callbackJ
-        vcbData->callback = json_object_get_userdata(callbackJ);
-        if (!vcbData->callback || !PyCallable_Check(vcbData->callback)) {
-            errorMsg = "(hoops) verb has no callable function";
-            goto OnErrorExit;
-        }
+    // prepare calling argument vector
+    if (GlueArgvInit(&args, nparams + 1) < 0) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
+    }
+    args.argv[0] = PyRqtObjectNew(glue);
+    if (!args.argv[0]) {
+        errorMsg = "out of memory";
+        goto OnErrorExit;
     }
 
-    // prepare calling argument list
-    PyObject* argsP = PyTuple_New(nparams + 1);
-    glue->usage++;
-    PyTuple_SetItem(
-      argsP, 0, PyCapsule_New(glue, GLUE_AFB_UID, GlueFreeCapsuleCb));
-
-    // retreive input arguments and convert them to json
+    // retreive input arguments with their native type, bytearrays are
+    // borrowed from afb_data without copy and JSON may be lazily viewed
     for (int idx = 0; idx < nparams; idx++) {
-        afb_data_t argD;
-        json_object* argJ;
-        err = afb_data_convert(params[idx], &afb_type_predefined_json_c, &argD);
-        if (err) {
-            errorMsg = "fail converting input params to json";
+        args.argv[idx + 1] =
+          convert_AfbData_to_PyView(params[idx], verb->jsonview);
+        if (!args.argv[idx + 1]) {
+            errorMsg = "fail converting input params";
             goto OnErrorExit;
         }
-        argJ = afb_data_ro_pointer(argD);
-        PyTuple_SetItem(argsP, idx + 1, jsonToPyObj(argJ));
-        afb_data_unref(argD);
     }
 
-    PyObject* resultP =
-      PyObject_Call((PyObject*)vcbData->callback, argsP, NULL);
+    uint64_t converted = GlueNowNs();
+    GlueHistoAdd(&verb->convert, converted - gil.acquired);
+
+    PyObject* resultP = GlueArgvCall(verb->callbackP, &args);
+    GlueArgvClear(&args);
+    GlueHistoAdd(&verb->exec, GlueNowNs() - converted);
     if (!resultP) {
         errorMsg = "error during verb callback function call";
         goto OnErrorExit;
     }
-    Py_DECREF(argsP);
-
-    if (resultP) {
-        PyObject* slotP;
-        json_object* slotJ;
-        long status, count;
-
-        if (PyTuple_Check(resultP)) {
-            count = PyTuple_GET_SIZE(resultP);
-            afb_data_t reply[count];
-            slotP = PyTuple_GetItem(resultP, 0);
-            if (!PyLong_Check(slotP)) {
-                errorMsg = "Response 1st element should be status/integer";
-                goto OnErrorExit;
-            }
-            status = PyLong_AsLong(slotP);
-            for (long idx = 0; idx < count - 1; idx++) {
-                slotP = PyTuple_GetItem(resultP, idx + 1);
-                int hasError = 0;
-                slotJ = pyObjToJson(slotP, &hasError);
-                if (hasError) {
-                    errorMsg = "(hoops) not json convertible response";
-                    goto OnErrorExit;
-                }
-                afb_create_data_raw(&reply[idx],
-                                    AFB_PREDEFINED_TYPE_JSON_C,
-                                    slotJ,
-                                    0,
-                                    (void*)json_object_put,
-                                    slotJ);
-            }
 
-            // respond request and free ressources.
-            GlueAfbReply(glue, status, count - 1, reply);
-
-        } else if (PyLong_Check(resultP)) {
-            status = PyLong_AsLong(resultP);
-            GlueAfbReply(glue, status, 0, NULL);
-        }
-        // for (int idx=0; idx <nparams; idx++) afb_data_unref(argsD[idx]);
+    // async def verbs reply when their coroutine completes
+    if (PyCoro_CheckExact(resultP)) {
+        errorMsg = GlueVerbAwait(glue, resultP);
         Py_DECREF(resultP);
+        if (errorMsg)
+            goto OnErrorExit;
+        GlueGilRelease(&gil, verb);
+        return;
     }
 
-    PyGILState_Release(gilState);
+    errorMsg = GlueVerbReply(glue, verb, resultP);
+    Py_DECREF(resultP);
+    if (errorMsg)
+        goto OnErrorExit;
+
+    GlueGilRelease(&gil, verb);
     return;
 
-OnErrorExit: {
-    afb_data_t reply;
-    json_object* errorJ = PyJsonDbg(errorMsg);
-    GLUE_AFB_WARNING(glue,
-                     "verb=[%s] python=%s",
-                     afb_req_get_called_verb(afbRqt),
-                     json_object_get_string(errorJ));
-    afb_create_data_raw(&reply,
-                        AFB_PREDEFINED_TYPE_JSON_C,
-                        errorJ,
-                        0,
-                        (void*)json_object_put,
-                        errorJ);
-    GlueAfbReply(glue, -1, 1, &reply);
-    PyGILState_Release(gilState);
-}
+OnErrorExit:
+    GlueArgvClear(&args);
+    GlueVerbError(glue, verb, errorMsg);
+    GlueGilRelease(&gil, verb);
 }
 
 int
@@ -234,7 +319,7 @@ GlueCtrlCb(afb_api_t apiv4,
            void* userdata)
 {
     GlueHandleT* glue = (GlueHandleT*)userdata;
-    static int orphan = 0;
+    static unsigned long orphan = 0;
     const char* state;
     int status = 0;
 
@@ -261,9 +346,9 @@ GlueCtrlCb(afb_api_t apiv4,
 
         case afb_ctlid_Orphan_Event:
             GLUE_AFB_WARNING(glue,
-                             "Orphan event=%s count=%d",
+                             "Orphan event=%s count=%lu",
                              ctlarg->orphan_event.name,
-                             orphan++);
+                             GLUE_COUNTER_INC(orphan));
             state = "orphan";
             break;
 
@@ -284,20 +369,21 @@ GlueCtrlCb(afb_api_t apiv4,
 
         // effectively exec PY script code
         GLUE_AFB_NOTICE(glue, "GlueCtrlCb: state=[%s]", state);
-        PyGILState_STATE gilState = PyGILState_Ensure();
-        glue->usage++;
+        GlueGilT gil;
+        GlueGilEnsure(&gil, GLUE_GIL_CONTROL);
+        GLUE_USAGE_INC(glue);
         PyObject* resultP = PyObject_CallFunction(
           glue->api.ctrlCb,
           "Os",
           PyCapsule_New(glue, GLUE_AFB_UID, GlueFreeCapsuleCb),
           state);
         if (!resultP) {
-            PyGILState_Release(gilState);
+            GlueGilRelease(&gil, NULL);
             goto OnErrorExit;
         }
         status = (int)PyLong_AsLong(resultP);
         Py_DECREF(resultP);
-        PyGILState_Release(gilState);
+        GlueGilRelease(&gil, NULL);
     }
     return status;
 
@@ -316,11 +402,12 @@ GlueStartupCb(void* config, void* userdata)
     int status = 0;
 
     if (async->callbackP) {
-        PyGILState_STATE state = PyGILState_Ensure();
+        GlueGilT gil;
+        GlueGilEnsure(&gil, GLUE_GIL_STARTUP);
 
         PyObject* argsP = PyTuple_New(2);
         if (!argsP) {
-            PyGILState_Release(state);
+            GlueGilRelease(&gil, NULL);
             goto OnErrorExit;
         }
 
@@ -334,7 +421,7 @@ GlueStartupCb(void* config, void* userdata)
         PyObject* resultP = PyObject_Call(async->callbackP, argsP, NULL);
         Py_DECREF(argsP);
         if (!resultP) {
-            PyGILState_Release(state);
+            GlueGilRelease(&gil, NULL);
             goto OnErrorExit;
         }
         status = (int)PyLong_AsLong(resultP);
@@ -343,7 +430,7 @@ GlueStartupCb(void* config, void* userdata)
         Py_XDECREF(async->userdataP);
         free(async);
 
-        PyGILState_Release(state);
+        GlueGilRelease(&gil, NULL);
     }
     return status;
 
@@ -353,33 +440,27 @@ OnErrorExit: {
 }
 }
 
-void
-GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
+// build the info verb document as ready to send JSON text, the GIL is only
+// taken to read uid and info from the api config
+static afb_data_t
+GlueInfoBuild(GlueHandleT* glue)
 {
-    PyGILState_STATE gilState = PyGILState_Ensure();
-
-    afb_api_t apiv4 = afb_req_get_api(afbRqt);
-    afb_data_t reply;
-
-    GlueHandleT* glue = afb_api_get_userdata(apiv4);
-    assert(glue->magic == GLUE_API_MAGIC_TAG);
+    afb_api_t apiv4 = glue->api.afb;
+    afb_data_t info = NULL;
 
-    // extract uid + info from API config
-    const char *uid, *info = NULL;
+    json_object* metaJ = json_object_new_object();
+    PyGILState_STATE gilState = PyGILState_Ensure();
     PyObject* uidP = PyDict_GetItemString(glue->api.configP, "uid");
     PyObject* infoP = PyDict_GetItemString(glue->api.configP, "info");
-
-    uid = PyUnicode_AsUTF8(uidP);
-    if (infoP)
-        info = PyUnicode_AsUTF8(infoP);
-
+    const char* uid = uidP ? PyUnicode_AsUTF8(uidP) : NULL;
+    const char* text = infoP ? PyUnicode_AsUTF8(infoP) : NULL;
+    if (uid)
+        json_object_object_add(metaJ, "uid", json_object_new_string(uid));
+    if (text)
+        json_object_object_add(metaJ, "info", json_object_new_string(text));
+    PyErr_Clear();
     PyGILState_Release(gilState);
 
-    json_object* metaJ = json_object_new_object();
-    json_object_object_add(metaJ, "uid", json_object_new_string(uid));
-    if (info != NULL)
-        json_object_object_add(metaJ, "info", json_object_new_string(info));
-
     // extract info from each verb
     json_object* verbsJ = json_object_new_array();
     for (int idx = 0; idx < afb_api_v4_verb_count(apiv4); idx++) {
@@ -390,8 +471,7 @@ GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
             AfbVcbDataT* vcbData = afbVerb->vcbdata;
             if (vcbData->magic != AfbAddVerbs)
                 continue;
-            json_object_array_add(verbsJ, vcbData->configJ);
-            json_object_get(verbsJ);
+            json_object_array_add(verbsJ, json_object_get(vcbData->configJ));
         }
     }
     // info devtool require a group array
@@ -403,72 +483,127 @@ GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
     json_object* infoJ = json_object_new_object();
     json_object_object_add(infoJ, "metadata", metaJ);
     json_object_object_add(infoJ, "groups", groupsJ);
+
+    // serialized once, the text is shared by every reply
+    size_t len;
+    char* json = strdup(
+      json_object_to_json_string_length(infoJ, JSON_C_TO_STRING_PLAIN, &len));
+    json_object_put(infoJ);
+    if (json &&
+        afb_create_data_raw(
+          &info, AFB_PREDEFINED_TYPE_JSON, json, len + 1, free, json) < 0)
+        info = NULL;
+    return info;
+}
+
+// drop the cached info document, rebuilt by the next info request
+void
+GlueInfoInvalidate(GlueHandleT* glue)
+{
+    pthread_mutex_lock(&glue->api.infoMutex);
+    afb_data_t info = glue->api.info;
+    glue->api.info = NULL;
+    glue->api.infoGen++;
+    pthread_mutex_unlock(&glue->api.infoMutex);
+    if (info)
+        afb_data_unref(info);
+}
+
+void
+GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
+{
+    GlueHandleT* glue = afb_api_get_userdata(afb_req_get_api(afbRqt));
+    assert(glue->magic == GLUE_API_MAGIC_TAG);
+
+    pthread_mutex_lock(&glue->api.infoMutex);
+    afb_data_t info = glue->api.info;
+    unsigned gen = glue->api.infoGen;
+    if (info)
+        afb_data_addref(info);
+    pthread_mutex_unlock(&glue->api.infoMutex);
+
+    // build outside of the lock, a concurrent invalidation wins
+    if (!info) {
+        info = GlueInfoBuild(glue);
+        if (!info) {
+            afb_req_reply(afbRqt, AFB_ERRNO_OUT_OF_MEMORY, 0, NULL);
+            return;
+        }
+        pthread_mutex_lock(&glue->api.infoMutex);
+        if (!glue->api.info && glue->api.infoGen == gen)
+            glue->api.info = afb_data_addref(info);
+        pthread_mutex_unlock(&glue->api.infoMutex);
+    }
+    afb_req_reply(afbRqt, 0, 1, &info);
+}
+
+// optional monitoring verb, registered by the api 'stats' config key
+void
+GlueStatsVerbCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[])
+{
+    afb_data_t reply;
+    json_object* statsJ = GlueStatsJson(afb_req_get_api(afbRqt));
+
     afb_create_data_raw(&reply,
                         AFB_PREDEFINED_TYPE_JSON_C,
-                        infoJ,
+                        statsJ,
                         0,
                         (void*)json_object_put,
-                        infoJ);
+                        statsJ);
     afb_req_reply(afbRqt, 0, 1, &reply);
-    return;
 }
 
+// call an async context callback, GIL should be held
 static void
-GluePcallFunc(GlueHandleT* glue,
-              GlueAsyncCtxT* async,
-              const char* label,
-              int status,
-              unsigned nreplies,
-              afb_data_t const replies[])
+GluePcallRun(GlueHandleT* glue,
+             GlueAsyncCtxT* async,
+             const char* label,
+             int status,
+             unsigned nreplies,
+             afb_data_t const replies[])
 {
     const char* errorMsg = "internal-error";
-    PyObject* argsP = NULL;
+    GlueArgvT args = { .argv = NULL };
     PyObject* resultP = NULL;
 
-    PyGILState_STATE state = PyGILState_Ensure();
-
     // subcall was refused
     if (AFB_IS_BINDER_ERRNO(status)) {
         errorMsg = afb_error_text(status);
         goto OnErrorExit;
     }
 
-    // prepare calling argument list
-    argsP = PyTuple_New(nreplies + 3);
-    if (!argsP)
+    // prepare calling argument vector
+    if (GlueArgvInit(&args, nreplies + 3) < 0)
         goto OnErrorExit;
-    glue->usage++;
-    PyTuple_SetItem(
-      argsP, 0, PyCapsule_New(glue, GLUE_AFB_UID, GlueFreeCapsuleCb));
+    args.argv[0] = PyGlueHandleNew(glue);
     if (label)
-        PyTuple_SetItem(argsP, 1, PyUnicode_FromString(label));
+        args.argv[1] = PyUnicode_FromString(label);
     else
-        PyTuple_SetItem(argsP, 1, PyLong_FromLong((long)status));
+        args.argv[1] = PyLong_FromLong((long)status);
 
     // add userdata if any
     if (!async->userdataP)
-        PyTuple_SetItem(argsP, 2, AFB_Py_NewRef(Py_None));
+        args.argv[2] = AFB_Py_NewRef(Py_None);
     else
-        PyTuple_SetItem(argsP, 2, AFB_Py_NewRef(async->userdataP));
+        args.argv[2] = AFB_Py_NewRef(async->userdataP);
 
     // push event data if any
-    errorMsg = PyPushAfbReply(argsP, 3, nreplies, replies);
+    errorMsg = PyPushAfbArgv(args.argv + 3, nreplies, replies);
     if (errorMsg)
         goto OnErrorExit;
 
-    resultP = PyObject_Call(async->callbackP, argsP, NULL);
+    resultP = GlueArgvCall(async->callbackP, &args);
     if (!resultP) {
         errorMsg = "function-fail";
         goto OnErrorExit;
     }
     Py_DECREF(resultP);
-    Py_DECREF(argsP);
-    PyGILState_Release(state);
+    GlueArgvClear(&args);
     return;
 
 OnErrorExit: {
     Py_XDECREF(resultP);
-    Py_XDECREF(argsP);
+    GlueArgvClear(&args);
     const char* uid = async->uid;
     json_object* errorJ = PyJsonDbg(errorMsg);
     if (glue->magic != GLUE_RQT_MAGIC_TAG)
@@ -488,10 +623,196 @@ OnErrorExit: {
                             errorJ);
         GlueAfbReply(glue, -1, 1, &reply);
     }
-    PyGILState_Release(state);
 }
 }
 
+static void
+GluePcallFunc(GlueHandleT* glue,
+              GlueAsyncCtxT* async,
+              const char* label,
+              int status,
+              unsigned nreplies,
+              afb_data_t const replies[])
+{
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_CALLBACK);
+    GluePcallRun(glue, async, label, status, nreplies, replies);
+    GlueGilRelease(&gil, NULL);
+}
+
+// release one reference on a callmany barrier, replies not taken by the
+// caller are dropped with the last one
+void
+GlueCallManyUnref(GlueCallManyT* many)
+{
+    pthread_mutex_lock(&many->mutex);
+    unsigned usage = --many->usage;
+    pthread_mutex_unlock(&many->mutex);
+    if (usage)
+        return;
+
+    for (unsigned idx = 0; idx < many->count; idx++) {
+        afb_data_array_unref(many->items[idx].nreplies,
+                             many->items[idx].replies);
+        GlueDataFree(many->items[idx].replies, many->items[idx].nreplies);
+    }
+    pthread_mutex_destroy(&many->mutex);
+    free(many);
+}
+
+// leave afb_sched_sync once, many->mutex should be held so that the waiter
+// cannot return before afb_sched_leave did
+static void
+GlueCallManyLeave(GlueCallManyT* many)
+{
+    if (many->left || many->abandoned || !many->lock)
+        return;
+    many->left = 1;
+    afb_sched_leave(many->lock);
+}
+
+// callmany timeout: abandon pending subcalls and wake up the waiter. The
+// timer holds a barrier reference, once left it only releases it.
+static void
+GlueCallManyTimerCb(afb_timer_x4_t timer, void* userdata, unsigned decount)
+{
+    GlueCallManyT* many = (GlueCallManyT*)userdata;
+
+    pthread_mutex_lock(&many->mutex);
+    if (!many->left) {
+        GlueCallManyLeave(many);
+        many->abandoned = 1;
+    }
+    pthread_mutex_unlock(&many->mutex);
+    GlueCallManyUnref(many);
+}
+
+static void
+GlueCallManyDone(GlueCallItemT* item,
+                 int status,
+                 unsigned nreplies,
+                 afb_data_t const replies[])
+{
+    GlueCallManyT* many = item->many;
+    afb_data_t* copy = NULL;
+
+    // replies are only lent to the callback
+    if (nreplies) {
+        copy = GlueDataAlloc(nreplies);
+        if (copy) {
+            for (unsigned idx = 0; idx < nreplies; idx++)
+                copy[idx] = afb_data_addref(replies[idx]);
+        } else {
+            status = AFB_ERRNO_OUT_OF_MEMORY;
+            nreplies = 0;
+        }
+    }
+
+    pthread_mutex_lock(&many->mutex);
+    if (!many->abandoned) {
+        item->status = status;
+        item->nreplies = nreplies;
+        item->replies = copy;
+        item->done = 1;
+        copy = NULL;
+    }
+    // once abandoned, afb_sched_sync returned and its lock is gone
+    if (--many->pending == 0 && many->launched)
+        GlueCallManyLeave(many);
+    pthread_mutex_unlock(&many->mutex);
+
+    if (copy) {
+        afb_data_array_unref(nreplies, copy);
+        GlueDataFree(copy, nreplies);
+    }
+    GlueCallManyUnref(many);
+}
+
+static void
+GlueApiManyCb(void* userdata,
+              int status,
+              unsigned nreplies,
+              afb_data_t const replies[],
+              afb_api_t api)
+{
+    GlueCallManyDone(userdata, status, nreplies, replies);
+}
+
+static void
+GlueRqtManyCb(void* userdata,
+              int status,
+              unsigned nreplies,
+              afb_data_t const replies[],
+              afb_req_t req)
+{
+    GlueCallManyDone(userdata, status, nreplies, replies);
+}
+
+// runs under afb_sched_sync: launch every subcall in one pass, the lock is
+// left by the last completion or by the timeout timer
+void
+GlueCallManyEnterCb(int signum, void* userdata, struct afb_sched_lock* lock)
+{
+    GlueCallManyT* many = (GlueCallManyT*)userdata;
+    GlueHandleT* glue = many->glue;
+    afb_timer_t timer;
+
+    if (signum) {
+        afb_sched_leave(lock);
+        return;
+    }
+
+    // each launched subcall holds a reference released by its completion
+    pthread_mutex_lock(&many->mutex);
+    many->lock = lock;
+    many->usage += many->count;
+    pthread_mutex_unlock(&many->mutex);
+
+    for (unsigned idx = 0; idx < many->count; idx++) {
+        GlueCallItemT* item = &many->items[idx];
+        if (glue->magic == GLUE_RQT_MAGIC_TAG)
+            afb_req_subcall(glue->rqt.afb,
+                            item->api,
+                            item->verb,
+                            (int)item->nparams,
+                            item->params,
+                            afb_req_subcall_catch_events,
+                            GlueRqtManyCb,
+                            item);
+        else
+            afb_api_call(GlueGetApi(glue),
+                         item->api,
+                         item->verb,
+                         (int)item->nparams,
+                         item->params,
+                         GlueApiManyCb,
+                         item);
+    }
+
+    pthread_mutex_lock(&many->mutex);
+    many->launched = 1;
+    if (many->pending == 0) {
+        GlueCallManyLeave(many);
+    } else if (many->timeout) {
+        // one shot timer, released by libafb once fired
+        many->usage++;
+        if (afb_timer_create(&timer,
+                             0,
+                             many->timeout,
+                             0,
+                             1,
+                             (unsigned)many->timeout * 1000,
+                             0,
+                             GlueCallManyTimerCb,
+                             many,
+                             1)) {
+            many->usage--;
+            LIBAFB_ERROR("callmany fail to arm timeout timer");
+        }
+    }
+    pthread_mutex_unlock(&many->mutex);
+}
+
 void
 GlueJobCallCb(int signum, void* userdata)
 {
@@ -509,6 +830,71 @@ GlueJobEnterCb(int signum, void* userdata, struct afb_sched_lock* afbLock)
     GluePcallFunc(glue, &glue->job.async, NULL, signum, 0, NULL);
 }
 
+// convert event data once for every handler, data keep their native type
+// and bytearrays are borrowed without copy
+static const char*
+GlueEventData(GlueArgvT* data, unsigned nparams, afb_data_x4_t const params[])
+{
+    if (GlueArgvInit(data, nparams) < 0)
+        return "out of memory";
+    for (unsigned idx = 0; idx < nparams; idx++) {
+        data->argv[idx] = convert_AfbData_to_PyView(params[idx], 0);
+        if (!data->argv[idx])
+            return "unsupported event data type";
+    }
+    return NULL;
+}
+
+// call a python event handler. Steals handleP, GIL should be held.
+static void
+GlueEventCall(GlueHandleT* glue,
+              PyObject* handleP,
+              GlueAsyncCtxT* async,
+              PyObject* labelP,
+              GlueArgvT* data)
+{
+    const char* errorMsg = "internal-error";
+    GlueArgvT args = { .argv = NULL };
+
+    // prepare calling argument vector
+    if (GlueArgvInit(&args, data->count + 3) < 0) {
+        Py_XDECREF(handleP);
+        goto OnErrorExit;
+    }
+    args.argv[0] = handleP;
+    args.argv[1] = AFB_Py_NewRef(labelP);
+
+    // add userdata if any
+    if (!async->userdataP)
+        args.argv[2] = AFB_Py_NewRef(Py_None);
+    else
+        args.argv[2] = AFB_Py_NewRef(async->userdataP);
+
+    // push event data if any
+    for (size_t idx = 0; idx < data->count; idx++)
+        args.argv[idx + 3] = AFB_Py_NewRef(data->argv[idx]);
+
+    PyObject* resultP = GlueArgvCall(async->callbackP, &args);
+    if (!resultP) {
+        errorMsg = "function-fail";
+        goto OnErrorExit;
+    }
+    GlueArgvClear(&args);
+    Py_DECREF(resultP);
+    return;
+
+OnErrorExit: {
+    GlueArgvClear(&args);
+    json_object* errorJ = PyJsonDbg(errorMsg);
+    GLUE_AFB_WARNING(glue,
+                     "uid=%s info=%s error=%s",
+                     async->uid,
+                     errorMsg,
+                     json_object_get_string(errorJ));
+    json_object_put(errorJ);
+}
+}
+
 // used when declaring event with the api
 void
 GlueApiEventCb(void* userdata,
@@ -517,123 +903,217 @@ GlueApiEventCb(void* userdata,
                afb_data_x4_t const params[],
                afb_api_t api)
 {
-    PyGILState_STATE gilState = PyGILState_Ensure();
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_EVENT);
 
     const char* errorMsg;
+    GlueArgvT data = { .argv = NULL };
+    PyObject* labelP = NULL;
     GlueHandleT* glue = (GlueHandleT*)afb_api_get_userdata(api);
     assert(glue->magic == GLUE_API_MAGIC_TAG);
 
-    // on first call we compile configJ to boost following py api/verb calls
     AfbVcbDataT* vcbData = userdata;
     if (vcbData->magic != (void*)AfbAddEvents) {
         errorMsg = "(hoops) event invalid vcbData handle";
         goto OnErrorExit;
     }
 
-    // on first call we need to retreive original callback object from configJ
-    if (!vcbData->callback) {
-        json_object* callbackJ =
-          json_object_object_get(vcbData->configJ, "callback");
-        if (!callbackJ) {
-            errorMsg = "(hoops) event no callback defined";
-            goto OnErrorExit;
-        }
+    // async context was compiled by GlueEventsCompile before the api was
+    // created and is never written afterward, worker threads only read it
+    GlueAsyncCtxT* async = json_object_get_userdata(vcbData->configJ);
+    if (!async) {
+        errorMsg = "(hoops) event handler was not compiled";
+        goto OnErrorExit;
+    }
 
-        // create an async structure to use gluePcallFunc and extract callbackR
-        // from json userdata
-        GlueAsyncCtxT* async = calloc(1, sizeof(GlueAsyncCtxT));
-        if (async == NULL) {
-            errorMsg = "out of memory";
-            goto OnErrorExit;
-        }
-        async->callbackP = json_object_get_userdata(callbackJ);
-        if (!async->callbackP || !PyCallable_Check(async->callbackP)) {
-            errorMsg = "(hoops) event has no callable function";
-            free(async);
-            goto OnErrorExit;
-        }
-        // extract Python callable from callbackJ
-        vcbData->callback = async;
+    errorMsg = GlueEventData(&data, nparams, params);
+    labelP = PyUnicode_FromString(label);
+    if (errorMsg || !labelP) {
+        errorMsg = errorMsg ? errorMsg : "out of memory";
+        goto OnErrorExit;
     }
 
-    // GluePcallFunc (glue, (GlueAsyncCtxT*)vcbData->callback, label, 0,
-    // nparams, params);
-    GluePcallFunc(glue, (GlueAsyncCtxT*)vcbData->callback, label, 0, 0, NULL);
-    PyGILState_Release(gilState);
+    GlueEventCall(glue, PyGlueHandleNew(glue), async, labelP, &data);
+    GlueArgvClear(&data);
+    Py_DECREF(labelP);
+    GlueGilRelease(&gil, NULL);
     return;
+
 OnErrorExit:
+    GlueArgvClear(&data);
+    Py_XDECREF(labelP);
     GLUE_DBG_ERROR(glue, errorMsg);
-    PyGILState_Release(gilState);
+    GlueGilRelease(&gil, NULL);
 }
 
-// user when declaring event with libafb.evthandler
+// used for every pattern registered with libafb.evthandler, whatever pattern
+// libafb selected, every python handler matching the event is called within
+// the same GIL section
 void
-GlueEventCb(void* userdata,
-            const char* label,
-            unsigned nparams,
-            afb_data_x4_t const params[],
-            afb_api_t api)
+GlueEvtDispatchCb(void* userdata,
+                  const char* label,
+                  unsigned nparams,
+                  afb_data_x4_t const params[],
+                  afb_api_t api)
 {
-    GlueHandleT* glue = (GlueHandleT*)userdata;
-    assert(glue->magic == GLUE_EVT_MAGIC_TAG);
-    GlueAsyncCtxT* async = &glue->event.async;
+    GlueEvtDispatchT* dispatch = (GlueEvtDispatchT*)userdata;
+    GlueEvtPatternT* small[GLUE_ARGV_SMALL];
+    GlueEvtPatternT** matches = small;
+    GlueArgvT data = { .argv = NULL };
+    PyObject* labelP = NULL;
+    const char* errorMsg = NULL;
+    unsigned count;
 
-    const char* errorMsg = "internal-error";
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_EVENT);
+    GlueEvtDispatchLock(dispatch);
 
-    PyGILState_STATE state = PyGILState_Ensure();
+    if (dispatch->count > GLUE_ARGV_SMALL) {
+        matches = malloc(dispatch->count * sizeof(GlueEvtPatternT*));
+        if (!matches) {
+            errorMsg = "out of memory";
+            goto OnErrorExit;
+        }
+    }
+    count = GlueEvtDispatchMatch(dispatch, label, matches);
+    if (!count)
+        goto OnExit;
+
+    errorMsg = GlueEventData(&data, nparams, params);
+    labelP = PyUnicode_FromString(label);
+    if (errorMsg || !labelP) {
+        errorMsg = errorMsg ? errorMsg : "out of memory";
+        goto OnErrorExit;
+    }
 
-    // prepare calling argument list
-    PyObject* argsP = PyTuple_New(nparams + 3);
-    PyTuple_SetItem(argsP, 0, PyCapsule_New(glue, GLUE_AFB_UID, NULL));
-    if (label)
-        PyTuple_SetItem(argsP, 1, PyUnicode_FromString(label));
-    else
-        PyTuple_SetItem(argsP, 1, PyLong_FromLong((long)0));
+    // handlers may delete patterns, GlueEvtDispatchDel keeps them as
+    // zombies until we leave, deleted siblings are not called anymore
+    GlueEvtDispatchEnter(dispatch);
+    for (unsigned idx = 0; idx < count; idx++) {
+        if (matches[idx]->deleted)
+            continue;
+        GlueHandleT* glue = matches[idx]->handle;
+        matches[idx]->hits++;
+        GlueEventCall(glue,
+                      PyCapsule_New(glue, GLUE_AFB_UID, NULL),
+                      &glue->event.async,
+                      labelP,
+                      &data);
+    }
+    GlueEvtDispatchLeave(dispatch);
+    goto OnExit;
 
-    // add userdata if any
-    if (!async->userdataP)
-        PyTuple_SetItem(argsP, 2, AFB_Py_NewRef(Py_None));
-    else
-        PyTuple_SetItem(argsP, 2, AFB_Py_NewRef(async->userdataP));
+OnErrorExit:
+    LIBAFB_ERROR("event=%s dispatch error=%s", label, errorMsg);
+OnExit:
+    GlueArgvClear(&data);
+    Py_XDECREF(labelP);
+    if (matches != small)
+        free(matches);
+    GlueEvtDispatchUnlock(dispatch);
+    GlueGilRelease(&gil, NULL);
+}
 
-    // push event data if any
-    errorMsg = PyPushAfbReply(argsP, 3, nparams, params);
-    if (errorMsg)
-        goto OnErrorExit;
+static void
+GlueEvtPolicyTimerCb(afb_timer_x4_t timer, void* userdata, unsigned decount);
 
-    PyObject* resultP = PyObject_Call(async->callbackP, argsP, NULL);
-    if (!resultP) {
-        errorMsg = "function-fail";
-        goto OnErrorExit;
+// start a one shot timer ending the current period, mutex should be held
+static int
+GlueEvtPolicyArm(GlueEvtPolicyT* policy)
+{
+    afb_timer_t timer;
+    int err = afb_timer_create(&timer,
+                               0,
+                               policy->period / 1000,
+                               policy->period % 1000,
+                               1,
+                               policy->period,
+                               0,
+                               GlueEvtPolicyTimerCb,
+                               policy,
+                               1);
+    policy->armed = !err;
+    return err;
+}
+
+// end of period: push the latest payload if any and open a new period
+static void
+GlueEvtPolicyTimerCb(afb_timer_x4_t timer, void* userdata, unsigned decount)
+{
+    GlueEvtPolicyT* policy = (GlueEvtPolicyT*)userdata;
+    afb_data_t* params = NULL;
+    unsigned count = 0;
+    int pending;
+
+    pthread_mutex_lock(&policy->mutex);
+    pending = policy->pending;
+    if (pending) {
+        params = policy->params;
+        count = policy->count;
+        policy->params = NULL;
+        policy->pending = 0;
+        GlueEvtPolicyArm(policy);
+    } else {
+        policy->armed = 0;
     }
-    Py_DECREF(argsP);
-    Py_DECREF(resultP);
-    PyGILState_Release(state);
-    return;
+    pthread_mutex_unlock(&policy->mutex);
 
-OnErrorExit: {
-    Py_XDECREF(argsP);
-    const char* uid = async->uid;
-    json_object* errorJ = PyJsonDbg(errorMsg);
-    if (glue->magic != GLUE_RQT_MAGIC_TAG)
-        GLUE_AFB_WARNING(glue,
-                         "uid=%s info=%s error=%s",
-                         uid,
-                         errorMsg,
-                         json_object_get_string(errorJ));
-    else {
-        afb_data_t reply;
-        GLUE_AFB_WARNING(glue, "%s", json_object_get_string(errorJ));
-        afb_create_data_raw(&reply,
-                            AFB_PREDEFINED_TYPE_JSON_C,
-                            errorJ,
-                            0,
-                            (void*)json_object_put,
-                            errorJ);
-        GlueAfbReply(glue, -1, 1, &reply);
+    if (pending) {
+        afb_event_push(policy->evtid, count, params);
+        free(params);
     }
-    PyGILState_Release(state);
 }
+
+// push an event through its publishing policy, takes ownership of params
+int
+GlueEvtPolicyPush(GlueEvtPolicyT* policy,
+                  unsigned count,
+                  afb_data_t const params[])
+{
+    afb_data_t* dropped = NULL;
+    unsigned droppedCount = 0;
+    int pushNow = 0;
+
+    afb_data_t* copy = malloc((count + 1) * sizeof(afb_data_t));
+    if (!copy)
+        return afb_event_push(policy->evtid, count, params);
+    memcpy(copy, params, count * sizeof(afb_data_t));
+
+    pthread_mutex_lock(&policy->mutex);
+    if (!policy->armed && policy->leading) {
+        pushNow = 1;
+        GlueEvtPolicyArm(policy);
+    } else {
+        // latest value wins
+        if (policy->pending) {
+            dropped = policy->params;
+            droppedCount = policy->count;
+        }
+        policy->params = copy;
+        policy->count = count;
+        policy->pending = 1;
+        copy = NULL;
+
+        // no timer to flush it, push it now
+        if (!policy->armed && GlueEvtPolicyArm(policy) < 0) {
+            copy = policy->params;
+            policy->params = NULL;
+            policy->pending = 0;
+            pushNow = 1;
+        }
+    }
+    pthread_mutex_unlock(&policy->mutex);
+
+    if (dropped) {
+        afb_data_array_unref(droppedCount, dropped);
+        free(dropped);
+    }
+    if (pushNow) {
+        int status = afb_event_push(policy->evtid, count, params);
+        free(copy);
+        return status;
+    }
+    return 0;
 }
 
 void
@@ -644,6 +1124,35 @@ GlueTimerCb(afb_timer_x4_t timer, void* userdata, unsigned decount)
     GluePcallFunc(glue, &glue->timer.async, NULL, (int)decount, 0, NULL);
 }
 
+// run every due timer of a wheel tick under a single GIL acquisition
+void
+GlueWheelCb(afb_timer_x4_t timer, void* userdata, unsigned decount)
+{
+    GlueWheelT* wheel = (GlueWheelT*)userdata;
+    GlueWheelTimerT* due = GlueWheelCollect(wheel, GlueNowNs());
+    if (!due)
+        return;
+
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_TIMER);
+    while (due) {
+        GlueWheelTimerT* entry = due;
+        GlueHandleT* glue = entry->glue;
+        due = entry->next;
+
+        if (GlueWheelRun(entry, GlueNowNs()))
+            GluePcallRun(
+              glue, &glue->timer.async, NULL, (int)entry->decount, 0, NULL);
+        if (GlueWheelRearm(entry, GlueNowNs())) {
+            free(entry);
+            GlueTimerClear(glue);
+            free(glue);
+        }
+    }
+    GlueGilRelease(&gil, NULL);
+    GlueWheelDone(wheel);
+}
+
 void
 GlueJobPostCb(int signum, void* userdata)
 {
@@ -655,7 +1164,7 @@ GlueJobPostCb(int signum, void* userdata)
     Py_DecRef(handle->async.callbackP);
     if (handle->async.userdataP)
         Py_DecRef(handle->async.userdataP);
-    free(handle);
+    GluePoolFree(GLUE_POOL_CALL, handle);
 }
 
 void
@@ -670,7 +1179,7 @@ GlueApiSubcallCb(void* userdata,
     GluePcallFunc(
       handle->glue, &handle->async, NULL, status, nreplies, replies);
     free(handle->async.uid);
-    free(handle);
+    GluePoolFree(GLUE_POOL_CALL, handle);
 }
 
 void
@@ -685,5 +1194,51 @@ GlueRqtSubcallCb(void* userdata,
     GluePcallFunc(
       handle->glue, &handle->async, NULL, status, nreplies, replies);
     free(handle->async.uid);
-    free(handle);
+    GluePoolFree(GLUE_POOL_CALL, handle);
+}
+
+// resolve the asyncio future of libafb.call with a libafb.response
+static void
+GlueFutureSubcallCb(GlueCallHandleT* handle,
+                    int status,
+                    unsigned nreplies,
+                    afb_data_t const replies[])
+{
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_FUTURE);
+    PyObject* futureP = handle->async.userdataP;
+
+    PyObject* responseP = PyResponseNew(status, nreplies, replies);
+    if (!responseP || GlueAioResolve(futureP, responseP) < 0) {
+        GLUE_AFB_WARNING(handle->glue, "fail to resolve libafb.call future");
+        PyErr_Print();
+    }
+    Py_XDECREF(responseP);
+    Py_DECREF(futureP);
+    GluePoolFree(GLUE_POOL_CALL, handle);
+    GlueGilRelease(&gil, NULL);
+}
+
+void
+GlueApiFutureCb(void* userdata,
+                int status,
+                unsigned nreplies,
+                afb_data_t const replies[],
+                afb_api_t api)
+{
+    GlueCallHandleT* handle = (GlueCallHandleT*)userdata;
+    assert(handle->magic == GLUE_CALL_MAGIC_TAG);
+    GlueFutureSubcallCb(handle, status, nreplies, replies);
+}
+
+void
+GlueRqtFutureCb(void* userdata,
+                int status,
+                unsigned nreplies,
+                afb_data_t const replies[],
+                afb_req_t req)
+{
+    GlueCallHandleT* handle = (GlueCallHandleT*)userdata;
+    assert(handle->magic == GLUE_CALL_MAGIC_TAG);
+    GlueFutureSubcallCb(handle, status, nreplies, replies);
 }
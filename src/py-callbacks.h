@@ -32,11 +32,11 @@
 #include "py-utils.h"
 
 void
-GlueEventCb(void *userdata,
-            const char *event_name,
-            unsigned nparams,
-            afb_data_x4_t const params[],
-            afb_api_t api);
+GlueEvtDispatchCb(void *userdata,
+                  const char *event_name,
+                  unsigned nparams,
+                  afb_data_x4_t const params[],
+                  afb_api_t api);
 void
 GlueApiEventCb(void *userdata,
                const char *event_name,
@@ -55,11 +55,31 @@ GlueRqtSubcallCb(void *userdata,
                  unsigned nreplies,
                  afb_data_t const replies[],
                  afb_req_t req);
+void
+GlueCallManyUnref(GlueCallManyT *many);
+void
+GlueCallManyEnterCb(int signum, void *userdata, struct afb_sched_lock *lock);
+void
+GlueApiFutureCb(void *userdata,
+                int status,
+                unsigned nreplies,
+                afb_data_t const replies[],
+                afb_api_t api);
+void
+GlueRqtFutureCb(void *userdata,
+                int status,
+                unsigned nreplies,
+                afb_data_t const replies[],
+                afb_req_t req);
 
 void
 GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[]);
 void
+GlueInfoInvalidate(GlueHandleT *glue);
+void
 GlueApiVerbCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[]);
+void
+GlueStatsVerbCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[]);
 int
 GlueCtrlCb(afb_api_t apiv4, afb_ctlid_t ctlid, afb_ctlarg_t ctlarg, void *userdata);
 int
@@ -68,6 +88,12 @@ void
 GlueInfoCb(afb_req_t afbRqt, unsigned nparams, afb_data_t const params[]);
 void
 GlueTimerCb(afb_timer_x4_t timer, void *userdata, unsigned decount);
+void
+GlueWheelCb(afb_timer_x4_t timer, void *userdata, unsigned decount);
+int
+GlueEvtPolicyPush(GlueEvtPolicyT *policy,
+                  unsigned count,
+                  afb_data_t const params[]);
 
 void
 GlueJobPostCb(int signum, void *userdata);
@@ -24,12 +24,19 @@
 #include <frameobject.h>
 
 #include <assert.h>
+#include <fnmatch.h>
+#include <math.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 
 #include "py-afb.h"
+#include "py-callbacks.h"
 #include "py-utils.h"
 
 #include <semaphore.h>
@@ -64,6 +71,437 @@ GlueGetApi(GlueHandleT* glue)
     return afbApi;
 }
 
+// build the dispatch record of one python verb from its configJ, glue is
+// the api glue providing the default reply encoding
+static const char*
+GlueVerbNew(GlueHandleT* glue, json_object* verbJ, GlueVerbT** verbOut)
+{
+    json_object* callbackJ = json_object_object_get(verbJ, "callback");
+    if (!callbackJ)
+        return "(hoops) verb no callback defined";
+
+    PyObject* callbackP = json_object_get_userdata(callbackJ);
+    if (!callbackP || !PyCallable_Check(callbackP))
+        return "(hoops) verb has no callable function";
+
+    // container replies encoding, verb config overloads api config
+    GlueEncodingE encoding = GLUE_ENCODING_JSONC;
+    const char* encodingS = NULL;
+    json_object* encodingJ = json_object_object_get(verbJ, "encoding");
+    if (encodingJ) {
+        encodingS = json_object_get_string(encodingJ);
+    } else if (glue && glue->magic == GLUE_API_MAGIC_TAG &&
+               glue->api.configP) {
+        PyObject* encodingP =
+          PyDict_GetItemString(glue->api.configP, "encoding");
+        if (encodingP)
+            encodingS = PyUnicode_AsUTF8(encodingP);
+        if (!encodingS)
+            PyErr_Clear();
+    }
+    if (encodingS) {
+        if (!strcasecmp(encodingS, "json"))
+            encoding = GLUE_ENCODING_JSON;
+        else if (strcasecmp(encodingS, "json-c"))
+            return "invalid encoding should be 'json' or 'json-c'";
+    }
+
+    GlueVerbT* verb = calloc(1, sizeof(GlueVerbT));
+    if (!verb)
+        return "out of memory";
+    verb->magic = GLUE_VERB_MAGIC_TAG;
+    json_object* nameJ = json_object_object_get(verbJ, "verb");
+    if (!nameJ)
+        nameJ = json_object_object_get(verbJ, "uid");
+    verb->verb = json_object_get_string(nameJ);
+    verb->callbackP = AFB_Py_NewRef(callbackP);
+    verb->encoding = encoding;
+    verb->jsonview =
+      json_object_get_boolean(json_object_object_get(verbJ, "jsonview"));
+    *verbOut = verb;
+    return NULL;
+}
+
+// build the dispatch record of a verb before it is registered. As for
+// events, the record is attached to the verb configJ, GlueApiVerbCb falls
+// back to it until GlueVerbsCompile ran.
+const char*
+GlueVerbPrepare(GlueHandleT* glue, json_object* verbJ)
+{
+    if (json_object_get_userdata(verbJ))
+        return NULL;
+
+    GlueVerbT* verb;
+    const char* errorMsg = GlueVerbNew(glue, verbJ, &verb);
+    if (errorMsg)
+        return errorMsg;
+    json_object_set_userdata(verbJ, verb, NULL);
+    return NULL;
+}
+
+// same for every verb declared in api config "verbs", before the api is
+// created
+const char*
+GlueVerbsPrepare(GlueHandleT* glue, json_object* apiJ)
+{
+    json_object* verbsJ = json_object_object_get(apiJ, "verbs");
+    if (!json_object_is_type(verbsJ, json_type_array))
+        return NULL;
+
+    for (size_t idx = 0; idx < json_object_array_length(verbsJ); idx++) {
+        const char* errorMsg =
+          GlueVerbPrepare(glue, json_object_array_get_idx(verbsJ, idx));
+        if (errorMsg)
+            return errorMsg;
+    }
+    return NULL;
+}
+
+// store the dispatch record of every python verb of the api in
+// vcbData->callback, records not prepared yet are built now. Requests may
+// already run on other threads, the record is published with a release
+// store matching the acquire load of GlueApiVerbCb.
+// Should be called with the GIL held.
+const char*
+GlueVerbsCompile(afb_api_t apiv4)
+{
+    for (unsigned idx = 0; idx < afb_api_v4_verb_count(apiv4); idx++) {
+        const afb_verb_t* afbVerb = afb_api_v4_verb_at(apiv4, idx);
+        if (!afbVerb)
+            break;
+        if (afbVerb->callback != GlueApiVerbCb)
+            continue;
+
+        AfbVcbDataT* vcbData = afbVerb->vcbdata;
+        if (vcbData->magic != (void*)AfbAddVerbs ||
+            __atomic_load_n(&vcbData->callback, __ATOMIC_ACQUIRE))
+            continue;
+
+        GlueVerbT* verb = json_object_get_userdata(vcbData->configJ);
+        if (!verb) {
+            const char* errorMsg =
+              GlueVerbNew(afb_api_get_userdata(apiv4), vcbData->configJ, &verb);
+            if (errorMsg)
+                return errorMsg;
+            verb->verb = afbVerb->verb;
+            json_object_set_userdata(vcbData->configJ, verb, NULL);
+        }
+        __atomic_store_n(&vcbData->callback, verb, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+static void
+GlueEventAsyncFree(json_object* eventJ, void* userdata)
+{
+    GlueAsyncCtxT* async = userdata;
+    PyGILState_STATE gilState = PyGILState_Ensure();
+    Py_XDECREF(async->callbackP);
+    PyGILState_Release(gilState);
+    free(async);
+}
+
+// build the async context of every event handler declared in api config
+// "events" before the api is created. The context is attached to the
+// handler configJ, where GlueApiEventCb picks it without further checks.
+const char*
+GlueEventsCompile(json_object* apiJ)
+{
+    json_object* eventsJ = json_object_object_get(apiJ, "events");
+    if (!json_object_is_type(eventsJ, json_type_array))
+        return NULL;
+
+    for (size_t idx = 0; idx < json_object_array_length(eventsJ); idx++) {
+        json_object* eventJ = json_object_array_get_idx(eventsJ, idx);
+        if (json_object_get_userdata(eventJ))
+            continue;
+
+        json_object* callbackJ = json_object_object_get(eventJ, "callback");
+        if (!callbackJ)
+            return "(hoops) event no callback defined";
+
+        PyObject* callbackP = json_object_get_userdata(callbackJ);
+        if (!callbackP || !PyCallable_Check(callbackP))
+            return "(hoops) event has no callable function";
+
+        GlueAsyncCtxT* async = calloc(1, sizeof(GlueAsyncCtxT));
+        if (!async)
+            return "out of memory";
+        async->uid = (char*)json_object_get_string(
+          json_object_object_get(eventJ, "uid"));
+        async->callbackP = AFB_Py_NewRef(callbackP);
+        json_object_set_userdata(eventJ, async, GlueEventAsyncFree);
+    }
+    return NULL;
+}
+
+// ------------------------------------------------------------
+// Event handlers dispatch table. Python patterns of an api are compiled in a
+// trie of their literal prefix: matching an event walks its name once and
+// only globs hanging on the walked nodes are checked with fnmatch.
+// Dispatchers are only accessed with the GIL held, free-threaded builds
+// serialize each of them with GlueEvtDispatchLock.
+// ------------------------------------------------------------
+static GlueEvtDispatchT* glueEvtDispatchs;
+
+#ifdef Py_GIL_DISABLED
+static PyMutex glueEvtDispatchsMutex;
+#endif
+
+static void
+GlueEvtTrieFree(GlueEvtTrieT* node)
+{
+    while (node) {
+        GlueEvtTrieT* sibling = node->sibling;
+        GlueEvtTrieFree(node->child);
+        free(node);
+        node = sibling;
+    }
+}
+
+static int
+GlueEvtDispatchCompile(GlueEvtDispatchT* dispatch)
+{
+    GlueEvtTrieFree(dispatch->trie);
+    dispatch->trie = calloc(1, sizeof(GlueEvtTrieT));
+    if (!dispatch->trie)
+        return -1;
+
+    for (GlueEvtPatternT* entry = dispatch->patterns; entry;
+         entry = entry->next) {
+        GlueEvtTrieT* node = dispatch->trie;
+        for (size_t idx = 0; idx < entry->prefix; idx++) {
+            GlueEvtTrieT* child = node->child;
+            while (child && child->key != entry->pattern[idx])
+                child = child->sibling;
+            if (!child) {
+                child = calloc(1, sizeof(GlueEvtTrieT));
+                if (!child)
+                    return -1;
+                child->key = entry->pattern[idx];
+                child->sibling = node->child;
+                node->child = child;
+            }
+            node = child;
+        }
+        entry->sibling = node->patterns;
+        node->patterns = entry;
+    }
+    return 0;
+}
+
+GlueEvtDispatchT*
+GlueEvtDispatchGet(afb_api_t apiv4, int create)
+{
+    GlueEvtDispatchT* dispatch;
+
+    GLUE_NOGIL_LOCK(glueEvtDispatchsMutex);
+    for (dispatch = glueEvtDispatchs; dispatch; dispatch = dispatch->next) {
+        if (dispatch->apiv4 == apiv4)
+            goto OnExit;
+    }
+    if (!create)
+        goto OnExit;
+
+    dispatch = calloc(1, sizeof(GlueEvtDispatchT));
+    if (!dispatch)
+        goto OnExit;
+#ifdef Py_GIL_DISABLED
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&dispatch->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+#endif
+    dispatch->apiv4 = apiv4;
+    dispatch->next = glueEvtDispatchs;
+    glueEvtDispatchs = dispatch;
+
+OnExit:
+    GLUE_NOGIL_UNLOCK(glueEvtDispatchsMutex);
+    return dispatch;
+}
+
+// no-op with the GIL. Otherwise recursive, as handlers may register or
+// delete patterns of their own api, and waits with the thread detached.
+void
+GlueEvtDispatchLock(GlueEvtDispatchT* dispatch)
+{
+#ifdef Py_GIL_DISABLED
+    if (pthread_mutex_trylock(&dispatch->mutex)) {
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock(&dispatch->mutex);
+        Py_END_ALLOW_THREADS
+    }
+#endif
+}
+
+void
+GlueEvtDispatchUnlock(GlueEvtDispatchT* dispatch)
+{
+#ifdef Py_GIL_DISABLED
+    pthread_mutex_unlock(&dispatch->mutex);
+#endif
+}
+
+GlueEvtPatternT*
+GlueEvtDispatchFind(GlueEvtDispatchT* dispatch, const char* pattern)
+{
+    for (GlueEvtPatternT* entry = dispatch->patterns; entry;
+         entry = entry->next) {
+        if (!strcmp(entry->pattern, pattern))
+            return entry;
+    }
+    return NULL;
+}
+
+const char*
+GlueEvtDispatchAdd(GlueEvtDispatchT* dispatch,
+                   const char* pattern,
+                   GlueHandleT* handle)
+{
+    GlueEvtPatternT** last = &dispatch->patterns;
+
+    GlueEvtPatternT* entry = calloc(1, sizeof(GlueEvtPatternT));
+    if (!entry)
+        return "out of memory";
+    entry->pattern = strdup(pattern);
+    if (!entry->pattern) {
+        free(entry);
+        return "out of memory";
+    }
+    entry->prefix = strcspn(pattern, "*?[\\");
+    entry->rank = dispatch->ranks++;
+    entry->handle = handle;
+
+    while (*last)
+        last = &(*last)->next;
+    *last = entry;
+    dispatch->count++;
+
+    if (GlueEvtDispatchCompile(dispatch) < 0) {
+        entry->handle = NULL; // still owned by the caller
+        GlueEvtDispatchDel(dispatch, pattern);
+        return "out of memory";
+    }
+    return NULL;
+}
+
+static void
+GlueEvtPatternFree(GlueEvtPatternT* entry)
+{
+    if (entry->handle)
+        GlueFreeHandleCb(entry->handle);
+    free(entry->pattern);
+    free(entry);
+}
+
+// remove a pattern and release its handle. Handlers run by GlueEvtDispatchCb
+// may delete their own or a sibling pattern, the entry is then kept as a
+// zombie until the outermost dispatch leaves.
+int
+GlueEvtDispatchDel(GlueEvtDispatchT* dispatch, const char* pattern)
+{
+    for (GlueEvtPatternT** prev = &dispatch->patterns; *prev;
+         prev = &(*prev)->next) {
+        GlueEvtPatternT* entry = *prev;
+        if (strcmp(entry->pattern, pattern))
+            continue;
+
+        *prev = entry->next;
+        dispatch->count--;
+        GlueEvtDispatchCompile(dispatch);
+        if (dispatch->dispatching) {
+            entry->deleted = 1;
+            entry->next = dispatch->zombies;
+            dispatch->zombies = entry;
+        } else {
+            GlueEvtPatternFree(entry);
+        }
+        return 0;
+    }
+    return -1;
+}
+
+// dispatcher lock should be held
+void
+GlueEvtDispatchEnter(GlueEvtDispatchT* dispatch)
+{
+    dispatch->dispatching++;
+}
+
+void
+GlueEvtDispatchLeave(GlueEvtDispatchT* dispatch)
+{
+    if (--dispatch->dispatching)
+        return;
+    while (dispatch->zombies) {
+        GlueEvtPatternT* entry = dispatch->zombies;
+        dispatch->zombies = entry->next;
+        GlueEvtPatternFree(entry);
+    }
+}
+
+// collect patterns matching name in registration order, matches should hold
+// dispatch->count entries. Returns the number of matches.
+unsigned
+GlueEvtDispatchMatch(GlueEvtDispatchT* dispatch,
+                     const char* name,
+                     GlueEvtPatternT** matches)
+{
+    GlueEvtTrieT* node = dispatch->trie;
+    unsigned count = 0;
+    size_t depth = 0;
+
+    while (node) {
+        for (GlueEvtPatternT* entry = node->patterns; entry;
+             entry = entry->sibling) {
+            const char* glob = entry->pattern + entry->prefix;
+            if (*glob ? fnmatch(glob, name + depth, 0) : name[depth])
+                continue;
+
+            // insertion sort on registration rank
+            unsigned idx = count++;
+            while (idx && matches[idx - 1]->rank > entry->rank) {
+                matches[idx] = matches[idx - 1];
+                idx--;
+            }
+            matches[idx] = entry;
+        }
+        if (!name[depth])
+            break;
+
+        GlueEvtTrieT* child = node->child;
+        while (child && child->key != name[depth])
+            child = child->sibling;
+        node = child;
+        depth++;
+    }
+    return count;
+}
+
+PyObject*
+GlueEvtDispatchStats(GlueEvtDispatchT* dispatch)
+{
+    PyObject* statsP = PyDict_New();
+    if (!statsP || !dispatch)
+        return statsP;
+
+    GlueEvtDispatchLock(dispatch);
+    for (GlueEvtPatternT* entry = dispatch->patterns; entry;
+         entry = entry->next) {
+        PyObject* hitsP = PyLong_FromUnsignedLong(entry->hits);
+        if (!hitsP || PyDict_SetItemString(statsP, entry->pattern, hitsP) < 0) {
+            Py_XDECREF(hitsP);
+            Py_CLEAR(statsP);
+            break;
+        }
+        Py_DECREF(hitsP);
+    }
+    GlueEvtDispatchUnlock(dispatch);
+    return statsP;
+}
+
 // Adaptation to python lesser than 3.14
 #if !defined(Py_LIMITED_API) || Py_LIMITED_API + 0 < 0x030d0000
 #define PyLong_FromInt32(x) PyLong_FromLong((long)(x))
@@ -160,6 +598,155 @@ convert_AfbData_to_PyObject(afb_data_t data)
     return result;
 }
 
+// Python object holding a reference on an afb_data and exporting its buffer
+// through the buffer protocol, so that memoryview can borrow it without copy
+typedef struct
+{
+    PyObject_HEAD afb_data_t data;
+} PyAfbDataObjectT;
+
+static int
+PyAfbDataGetBufferCb(PyObject* self, Py_buffer* view, int flags)
+{
+    PyAfbDataObjectT* holder = (PyAfbDataObjectT*)self;
+    void* pointer;
+    size_t size;
+
+    if (afb_data_get_constant(holder->data, &pointer, &size) < 0) {
+        PyErr_SetString(PyExc_BufferError, "afb data buffer not readable");
+        return -1;
+    }
+    return PyBuffer_FillInfo(
+      view, self, pointer ? pointer : "", (Py_ssize_t)size, 1, flags);
+}
+
+static void
+PyAfbDataFreeCb(PyObject* self)
+{
+    PyAfbDataObjectT* holder = (PyAfbDataObjectT*)self;
+    afb_data_unref(holder->data);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static PyBufferProcs PyAfbDataBufferProcs = {
+    .bf_getbuffer = PyAfbDataGetBufferCb,
+    .bf_releasebuffer = NULL,
+};
+
+PyTypeObject PyAfbDataType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "libafb.data",
+    .tp_doc = "AFB data buffer owner",
+    .tp_basicsize = sizeof(PyAfbDataObjectT),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = PyAfbDataFreeCb,
+    .tp_as_buffer = &PyAfbDataBufferProcs,
+};
+
+// libafb.lazy(fn) log argument, fn is only called when the message is
+// written. Plain callables are logged as any other object.
+typedef struct
+{
+    PyObject_HEAD PyObject* callableP;
+} PyLazyObjectT;
+
+static PyObject*
+PyLazyNewCb(PyTypeObject* type, PyObject* argsP, PyObject* kwds)
+{
+    PyObject* callableP;
+
+    if (kwds && PyDict_GET_SIZE(kwds)) {
+        PyErr_SetString(PyExc_TypeError, "syntax: lazy(callable)");
+        return NULL;
+    }
+    if (!PyArg_ParseTuple(argsP, "O:lazy", &callableP))
+        return NULL;
+    if (!PyCallable_Check(callableP)) {
+        PyErr_SetString(PyExc_TypeError, "lazy argument should be callable");
+        return NULL;
+    }
+
+    PyLazyObjectT* lazy = (PyLazyObjectT*)type->tp_alloc(type, 0);
+    if (!lazy)
+        return NULL;
+    lazy->callableP = AFB_Py_NewRef(callableP);
+    return (PyObject*)lazy;
+}
+
+static void
+PyLazyFreeCb(PyObject* self)
+{
+    Py_XDECREF(((PyLazyObjectT*)self)->callableP);
+    Py_TYPE(self)->tp_free(self);
+}
+
+PyTypeObject PyLazyType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "libafb.lazy",
+    .tp_doc = "Log argument evaluated only when the message is written",
+    .tp_basicsize = sizeof(PyLazyObjectT),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyLazyNewCb,
+    .tp_dealloc = PyLazyFreeCb,
+};
+
+// return a new reference on a log argument, libafb.lazy ones are evaluated.
+// Failing evaluations are reported and logged as None.
+static PyObject*
+GlueLazyEval(PyObject* argP)
+{
+    if (Py_TYPE(argP) != &PyLazyType)
+        return AFB_Py_NewRef(argP);
+
+    PyObject* valueP =
+      PyObject_CallObject(((PyLazyObjectT*)argP)->callableP, NULL);
+    if (!valueP) {
+        PyErr_Print();
+        Py_RETURN_NONE;
+    }
+    return valueP;
+}
+
+// Same as convert_AfbData_to_PyObject, except that bytearrays are returned as
+// a read-only memoryview borrowing the afb_data buffer instead of a copy. The
+// afb_data is released when the last view on it is dropped. When jsonview is
+// set, JSON containers are returned as libafb.JsonView.
+PyObject*
+convert_AfbData_to_PyView(afb_data_t data, int jsonview)
+{
+    PyAfbDataObjectT* holder;
+    PyObject* viewP;
+    afb_data_t other;
+    void* pointer;
+
+    if (data == NULL)
+        return convert_AfbData_to_PyObject(data);
+
+    // JSON objects/arrays are wrapped in a lazy libafb.JsonView
+    if (jsonview && (afb_data_type(data) == AFB_PREDEFINED_TYPE_JSON_C ||
+                     afb_data_type(data) == AFB_PREDEFINED_TYPE_JSON)) {
+        if (afb_data_convert(data, AFB_PREDEFINED_TYPE_JSON_C, &other) < 0)
+            return convert_AfbData_to_PyObject(data);
+        viewP = afb_data_get_constant(other, &pointer, NULL) < 0
+                  ? convert_AfbData_to_PyObject(other)
+                  : PyJsonViewNew(pointer);
+        afb_data_unref(other);
+        return viewP;
+    }
+
+    if (afb_typeid(afb_data_type(data)) != Afb_Typeid_Predefined_Bytearray)
+        return convert_AfbData_to_PyObject(data);
+
+    holder = PyObject_New(PyAfbDataObjectT, &PyAfbDataType);
+    if (holder == NULL)
+        return NULL;
+    holder->data = afb_data_addref(data);
+
+    viewP = PyMemoryView_FromObject((PyObject*)holder);
+    Py_DECREF(holder);
+    return viewP;
+}
+
 // retrieve subcall response and build PY response
 const char*
 PyPushAfbReply(PyObject* resultP,
@@ -176,6 +763,62 @@ PyPushAfbReply(PyObject* resultP,
     return NULL;
 }
 
+// same as PyPushAfbReply but filling a callback argument vector
+const char*
+PyPushAfbArgv(PyObject** argv, unsigned nreplies, const afb_data_t* replies)
+{
+    for (unsigned idx = 0; idx < nreplies; idx++) {
+        argv[idx] = convert_AfbData_to_PyObject(replies[idx]);
+        if (argv[idx] == NULL)
+            return "unsupported return data type";
+    }
+    return NULL;
+}
+
+// prepare a vector of count NULL arguments
+int
+GlueArgvInit(GlueArgvT* args, size_t count)
+{
+    PyObject** buffer = args->small;
+
+    if (count > GLUE_ARGV_SMALL) {
+        buffer = PyMem_Calloc(count + 1, sizeof(PyObject*));
+        if (!buffer) {
+            args->argv = NULL;
+            args->count = 0;
+            return -1;
+        }
+    } else {
+        memset(args->small, 0, sizeof(args->small));
+    }
+    args->argv = buffer + 1;
+    args->count = count;
+    return 0;
+}
+
+// release arguments references and vector buffer
+void
+GlueArgvClear(GlueArgvT* args)
+{
+    if (!args->argv)
+        return;
+    for (size_t idx = 0; idx < args->count; idx++)
+        Py_XDECREF(args->argv[idx]);
+    if (args->argv - 1 != args->small)
+        PyMem_Free(args->argv - 1);
+    args->argv = NULL;
+    args->count = 0;
+}
+
+PyObject*
+GlueArgvCall(PyObject* callableP, GlueArgvT* args)
+{
+    return PyObject_Vectorcall(callableP,
+                               args->argv,
+                               args->count | PY_VECTORCALL_ARGUMENTS_OFFSET,
+                               NULL);
+}
+
 void
 GlueVerbose(GlueHandleT* handle,
             int level,
@@ -242,9 +885,99 @@ PyInfoDbg(GlueHandleT* handle,
     Py_XDECREF(code);
 }
 
+// check handle verbosity before paying for frame walk and arguments
+int
+GlueWantsLog(GlueHandleT* handle, int level)
+{
+    switch (handle->magic) {
+        case GLUE_API_MAGIC_TAG:
+        case GLUE_EVT_MAGIC_TAG:
+        case GLUE_JOB_MAGIC_TAG:
+            return afb_api_wants_log_level(GlueGetApi(handle), level);
+
+        case GLUE_RQT_MAGIC_TAG:
+            return afb_req_wants_log_level(handle->rqt.afb, level);
+
+        default:
+            return 1;
+    }
+}
+
+// convert a log argument as the C formatter does, evaluating lazy ones
+static PyObject*
+GlueLogArg(PyObject* argP)
+{
+    PyObject* valueP = GlueLazyEval(argP);
+    if (!valueP)
+        return NULL;
+
+    if (PyLong_Check(valueP) || PyUnicode_Check(valueP) || valueP == Py_None)
+        return valueP;
+
+    json_object* argJ = pyObjToJson(valueP, /* hasError = */ NULL);
+    Py_DECREF(valueP);
+    if (!argJ) {
+        if (PyErr_Occurred())
+            PyErr_Print();
+        Py_RETURN_NONE;
+    }
+    PyObject* strP = PyUnicode_FromString(json_object_get_string(argJ));
+    json_object_put(argJ);
+    return strP;
+}
+
+// format with python '%' operator: no argument count limit, keyword
+// arguments are appended as key=value fields
+static PyObject*
+GlueLogFormat(PyObject* formatP,
+              PyObject* const* args,
+              Py_ssize_t count,
+              PyObject* kwnames)
+{
+    PyObject* textP = NULL;
+    PyObject* tupleP = PyTuple_New(count);
+    if (!tupleP)
+        return NULL;
+
+    for (Py_ssize_t idx = 0; idx < count; idx++) {
+        PyObject* argP = GlueLogArg(args[idx]);
+        if (!argP)
+            goto OnErrorExit;
+        PyTuple_SET_ITEM(tupleP, idx, argP);
+    }
+    textP = PyUnicode_Format(formatP, tupleP);
+    if (!textP)
+        goto OnErrorExit;
+
+    Py_ssize_t nkw = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t idx = 0; idx < nkw; idx++) {
+        PyObject* valueP = GlueLogArg(args[count + idx]);
+        if (!valueP)
+            goto OnErrorExit;
+        PyObject* fieldP = PyUnicode_FromFormat(
+          "%U %U=%S", textP, PyTuple_GET_ITEM(kwnames, idx), valueP);
+        Py_DECREF(valueP);
+        Py_DECREF(textP);
+        textP = fieldP;
+        if (!textP)
+            goto OnErrorExit;
+    }
+    Py_DECREF(tupleP);
+    return textP;
+
+OnErrorExit:
+    Py_XDECREF(textP);
+    Py_DECREF(tupleP);
+    return NULL;
+}
+
 // reference: https://bbs.archlinux.org/viewtopic.php?id=31087
 void
-PyPrintMsg(enum afb_syslog_levels level, PyObject* self, PyObject* args)
+PyPrintMsg(enum afb_syslog_levels level,
+           PyObject* self,
+           PyObject* const* args,
+           Py_ssize_t tupleSize,
+           PyObject* kwnames)
 {
     char const* errorMsg = NULL;
     char const* filename = NULL;
@@ -252,6 +985,28 @@ PyPrintMsg(enum afb_syslog_levels level, PyObject* self, PyObject* args)
     int linenum = 0;
     PyCodeObject* code = NULL;
 
+    if (tupleSize < 2) {
+        errorMsg = "syntax error: not enough arguments for afbprint(handle, "
+                   "format, ...)";
+        goto OnErrorExit;
+    }
+
+    GlueHandleT* handle = PyGlueHandleGet(args[0]);
+    if (!handle) {
+        errorMsg = "syntax afbprint(handle: is not a valid Glue handle)";
+        goto OnErrorExit;
+    }
+
+    // message would be dropped: skip frame walk and arguments conversion
+    if (!GlueWantsLog(handle, level))
+        return;
+
+    PyObject* formatP = args[1];
+    if (!PyUnicode_Check(formatP)) {
+        errorMsg = "Format should be a valid string";
+        goto OnErrorExit;
+    }
+
     if (level > AFB_SYSLOG_LEVEL_NOTICE) {
         // retreive debug info looping on frame would pop Python calling trace
         PyThreadState* ts = PyThreadState_Get();
@@ -273,38 +1028,39 @@ PyPrintMsg(enum afb_syslog_levels level, PyObject* self, PyObject* args)
         }
     }
 
-    Py_ssize_t tupleSize = PyTuple_Size(args);
-    if (tupleSize < 2) {
-        errorMsg = "syntax error: not enough arguments for afbprint(handle, "
-                   "format, ...)";
-        goto OnErrorExit;
-    }
-
-    PyObject* afbHandleP = PyTuple_GetItem(args, 0);
-    if (!PyCapsule_CheckExact(afbHandleP)) {
-        errorMsg = "syntax afbprint(handle: is not a valid opaque Glue handle)";
-        goto OnErrorExit;
-    }
+    const char* format = PyUnicode_AsUTF8(formatP);
 
-    GlueHandleT* handle = PyCapsule_GetPointer(afbHandleP, GLUE_AFB_UID);
-    if (!handle) {
-        errorMsg = "syntax afbprint(handle: is not a valid Glue handle)";
-        goto OnErrorExit;
+    // asynchronous mode, keyword fields or more arguments than the C
+    // formatter accepts: build the whole message as a python string
+    if (kwnames || tupleSize > 12 || GlueLogAsyncOn()) {
+        PyObject* textP =
+          GlueLogFormat(formatP, args + 2, tupleSize - 2, kwnames);
+        const char* text = textP ? PyUnicode_AsUTF8(textP) : NULL;
+        if (!text) {
+            PyErr_Print();
+            text = format;
+        }
+        if (GlueLogAsyncPush(handle, level, linenum, funcname, text) < 0)
+            GlueVerbose(handle, level, filename, linenum, funcname, "%s", text);
+        Py_XDECREF(textP);
+        Py_XDECREF(code);
+        return;
     }
 
-    PyObject* formatP = PyTuple_GetItem(args, 1);
-    if (!PyUnicode_Check(formatP)) {
-        errorMsg = "Format should be a valid string";
-        goto OnErrorExit;
-    }
-    const char* format = PyUnicode_AsUTF8(formatP);
     if (tupleSize > 2) {
-        int count = 0, index = 0;
+        int count = 0, index = 0, lazy = 0;
         void* param[10];
         json_object* paramJ[10];
+        PyObject* lazyP[10];
 
         for (int idx = 2; idx < tupleSize; idx++) {
-            PyObject* argP = PyTuple_GetItem(args, idx);
+            PyObject* argP = args[idx];
+
+            // lazy argument: only evaluated when message is emitted
+            if (Py_TYPE(argP) == &PyLazyType) {
+                argP = GlueLazyEval(argP);
+                lazyP[lazy++] = argP;
+            }
 
             if (PyLong_Check(argP)) {
                 param[count++] = (void*)PyLong_AsLong(argP);
@@ -347,6 +1103,8 @@ PyPrintMsg(enum afb_syslog_levels level, PyObject* self, PyObject* args)
         // release json object of nay
         for (int idx = 0; idx < index; idx++)
             json_object_put(paramJ[idx]);
+        for (int idx = 0; idx < lazy; idx++)
+            Py_DECREF(lazyP[idx]);
 
     } else {
         GlueVerbose(handle, level, filename, linenum, funcname, format);
@@ -454,6 +1212,9 @@ pyObjToJson(PyObject* objP, int* hasError)
     else if (PyFloat_Check(objP))
         valueJ = json_object_new_double(PyFloat_AsDouble(objP));
 
+    else if (PyJsonViewGetJson(objP))
+        valueJ = json_object_get(PyJsonViewGetJson(objP));
+
     else if (PyDict_Check(objP)) {
         valueJ = json_object_new_object();
         PyObject *keyP, *slotP;
@@ -521,6 +1282,592 @@ pyObjToJson(PyObject* objP, int* hasError)
     return valueJ;
 }
 
+// ------------------------------------------------------------
+// Conversion of a PyObject* to afb_data_t
+// ------------------------------------------------------------
+// afb data release callbacks may run from any thread
+void
+GluePyObjectRelease(void* userdata)
+{
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_RELEASE);
+    Py_DECREF((PyObject*)userdata);
+    GlueGilRelease(&gil, NULL);
+}
+
+static void
+GluePyBufferRelease(void* userdata)
+{
+    Py_buffer* view = (Py_buffer*)userdata;
+    GlueGilT gil;
+    GlueGilEnsure(&gil, GLUE_GIL_RELEASE);
+    PyBuffer_Release(view);
+    GlueGilRelease(&gil, NULL);
+    free(view);
+}
+
+bool
+_convert_py_argument_to_afb_data(PyObject* pyArg, afb_data_t* out, int index)
+{
+    if (pyArg == Py_None) {
+        // None can be represented as JSON "null"
+        if (afb_create_data_raw(
+              out, AFB_PREDEFINED_TYPE_JSON_C, NULL, 0, NULL, NULL) != 0) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create null parameter");
+            return false;
+        }
+    } else if (PyFloat_Check(pyArg)) {
+        double val = PyFloat_AsDouble(pyArg);
+        if (afb_create_data_copy(
+              out, AFB_PREDEFINED_TYPE_DOUBLE, &val, sizeof(val)) != 0) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create double parameter");
+            return false;
+        }
+    } else if (PyUnicode_Check(pyArg)) {
+        const char* str = PyUnicode_AsUTF8(pyArg);
+        if (!str) {
+            PyErr_SetString(PyExc_UnicodeError,
+                            "Failed to convert string to UTF-8");
+            return false;
+        }
+        Py_INCREF(pyArg);
+        if (afb_create_data_raw(out,
+                                AFB_PREDEFINED_TYPE_STRINGZ,
+                                str,
+                                strlen(str) + 1,
+                                GluePyObjectRelease,
+                                pyArg) != 0) {
+            Py_DECREF(pyArg);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create string parameter");
+            return false;
+        }
+    } else if (PyBool_Check(pyArg)) {
+        bool bval = (pyArg == Py_True);
+        if (afb_create_data_copy(
+              out, AFB_PREDEFINED_TYPE_BOOL, &bval, sizeof(bval)) != 0) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create boolean parameter");
+            return false;
+        }
+    } else if (PyBytes_Check(pyArg)) {
+        // bytes are immutable, afb data borrows their buffer
+        Py_INCREF(pyArg);
+        if (afb_create_data_raw(out,
+                                AFB_PREDEFINED_TYPE_BYTEARRAY,
+                                PyBytes_AS_STRING(pyArg),
+                                (size_t)PyBytes_GET_SIZE(pyArg),
+                                GluePyObjectRelease,
+                                pyArg) != 0) {
+            Py_DECREF(pyArg);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create bytearray parameter");
+            return false;
+        }
+    } else if (PyByteArray_Check(pyArg) || PyMemoryView_Check(pyArg)) {
+        // buffer is exported (bytearray cannot be resized) until afb data is
+        // released, content should not be modified meanwhile
+        Py_buffer* view = malloc(sizeof(Py_buffer));
+        if (!view) {
+            PyErr_NoMemory();
+            return false;
+        }
+        if (PyObject_GetBuffer(pyArg, view, PyBUF_SIMPLE) < 0) {
+            free(view);
+            return false;
+        }
+        if (afb_create_data_raw(out,
+                                AFB_PREDEFINED_TYPE_BYTEARRAY,
+                                view->buf,
+                                (size_t)view->len,
+                                GluePyBufferRelease,
+                                view) != 0) {
+            PyBuffer_Release(view);
+            free(view);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create bytearray parameter");
+            return false;
+        }
+    } else if (PyDict_Check(pyArg) || PyList_Check(pyArg) ||
+               PyTuple_Check(pyArg) || PyJsonViewGetJson(pyArg)) {
+        int hasError = 0;
+        json_object* jobj = pyObjToJson(pyArg, &hasError);
+        if (hasError) {
+            PyErr_SetString(PyExc_TypeError,
+                            "Failed to convert Python object to JSON");
+            return false;
+        }
+        if (afb_create_data_raw(out,
+                                AFB_PREDEFINED_TYPE_JSON_C,
+                                jobj,
+                                0,
+                                (void*)json_object_put,
+                                jobj) != 0) {
+            json_object_put(jobj);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create JSON parameter");
+            return false;
+        }
+    } else if (PyLong_Check(pyArg)) {
+        int64_t i64_value = PyLong_AsLongLong(pyArg);
+        if (i64_value == -1 && PyErr_Occurred()) {
+            PyErr_SetString(PyExc_OverflowError, "Integer value too large");
+            return false;
+        }
+        if (afb_create_data_copy(
+              out, AFB_PREDEFINED_TYPE_I64, &i64_value, sizeof(int64_t)) != 0) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Failed to create integer parameter");
+            return false;
+        }
+    } else {
+        PyErr_Format(PyExc_TypeError, "Unsupported type at position %d", index);
+        return false;
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------
+// Direct python object to JSON text serializer. Output is built in a
+// per-thread growable buffer, so serializing a reply costs a single
+// allocation for the final string instead of one json_object per node.
+// ------------------------------------------------------------
+typedef struct
+{
+    char* data;
+    size_t len;
+    size_t size;
+} GlueJsonBufT;
+
+// larger buffers are released once the reply is copied out
+#define GLUE_JSON_BUF_MAX (64 * 1024)
+
+static __thread GlueJsonBufT glueJsonBuf;
+static pthread_key_t glueJsonKey;
+static pthread_once_t glueJsonOnce = PTHREAD_ONCE_INIT;
+
+static void
+GlueJsonBufRelease(GlueJsonBufT* buf)
+{
+    free(buf->data);
+    buf->data = NULL;
+    buf->len = 0;
+    buf->size = 0;
+}
+
+static void
+GlueJsonThreadExit(void* userdata)
+{
+    GlueJsonBufRelease((GlueJsonBufT*)userdata);
+}
+
+static void
+GlueJsonKeyInit(void)
+{
+    pthread_key_create(&glueJsonKey, GlueJsonThreadExit);
+}
+
+static int
+GlueJsonReserve(GlueJsonBufT* buf, size_t len)
+{
+    if (buf->len + len < buf->size)
+        return 0;
+
+    size_t size = buf->size ? buf->size : 1024;
+    while (size <= buf->len + len)
+        size *= 2;
+
+    // register thread exit hook on first allocation
+    if (!buf->data) {
+        pthread_once(&glueJsonOnce, GlueJsonKeyInit);
+        pthread_setspecific(glueJsonKey, buf);
+    }
+
+    char* data = realloc(buf->data, size);
+    if (!data) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    buf->data = data;
+    buf->size = size;
+    return 0;
+}
+
+static int
+GlueJsonPut(GlueJsonBufT* buf, const char* str, size_t len)
+{
+    if (GlueJsonReserve(buf, len) < 0)
+        return -1;
+    memcpy(buf->data + buf->len, str, len);
+    buf->len += len;
+    return 0;
+}
+
+static int
+GlueJsonPutString(GlueJsonBufT* buf, PyObject* strP)
+{
+    static const char hex[] = "0123456789abcdef";
+    Py_ssize_t len;
+    const char* str = PyUnicode_AsUTF8AndSize(strP, &len);
+    if (!str)
+        return -1;
+
+    // worst case every byte is escaped as \u00XX
+    if (GlueJsonReserve(buf, (size_t)len * 6 + 2) < 0)
+        return -1;
+
+    char* out = buf->data + buf->len;
+    *out++ = '"';
+    for (Py_ssize_t idx = 0; idx < len; idx++) {
+        unsigned char c = (unsigned char)str[idx];
+        switch (c) {
+            case '"':
+            case '\\':
+                *out++ = '\\';
+                *out++ = (char)c;
+                break;
+            case '\n':
+                *out++ = '\\';
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = '\\';
+                *out++ = 'r';
+                break;
+            case '\t':
+                *out++ = '\\';
+                *out++ = 't';
+                break;
+            default:
+                if (c < 0x20) {
+                    memcpy(out, "\\u00", 4);
+                    out[4] = hex[c >> 4];
+                    out[5] = hex[c & 0xf];
+                    out += 6;
+                } else {
+                    *out++ = (char)c;
+                }
+        }
+    }
+    *out++ = '"';
+    buf->len = (size_t)(out - buf->data);
+    return 0;
+}
+
+static int
+GlueJsonPutDouble(GlueJsonBufT* buf, double value)
+{
+    char number[32];
+    int len;
+
+    if (isnan(value))
+        return GlueJsonPut(buf, "NaN", 3);
+    if (isinf(value))
+        return value > 0 ? GlueJsonPut(buf, "Infinity", 8)
+                         : GlueJsonPut(buf, "-Infinity", 9);
+
+    // shortest of 15/17 digits that round-trips
+    len = snprintf(number, sizeof(number), "%.15g", value);
+    if (strtod(number, NULL) != value)
+        len = snprintf(number, sizeof(number), "%.17g", value);
+    if (!strpbrk(number, ".eE") && len + 2 < (int)sizeof(number)) {
+        memcpy(number + len, ".0", 3);
+        len += 2;
+    }
+    return GlueJsonPut(buf, number, (size_t)len);
+}
+
+static int
+GlueJsonPutObject(GlueJsonBufT* buf, PyObject* objP)
+{
+    int status = -1;
+
+    if (objP == Py_None)
+        return GlueJsonPut(buf, "null", 4);
+
+    if (PyBool_Check(objP))
+        return objP == Py_True ? GlueJsonPut(buf, "true", 4)
+                               : GlueJsonPut(buf, "false", 5);
+
+    if (PyLong_Check(objP)) {
+        char number[24];
+        int overflow = 0;
+        long long value = PyLong_AsLongLongAndOverflow(objP, &overflow);
+        if (overflow) {
+            PyErr_SetString(
+              PyExc_ValueError,
+              "A Python integer overflows the supported size of JSON integers");
+            return -1;
+        }
+        int len = snprintf(number, sizeof(number), "%lld", value);
+        return GlueJsonPut(buf, number, (size_t)len);
+    }
+
+    if (PyFloat_Check(objP))
+        return GlueJsonPutDouble(buf, PyFloat_AS_DOUBLE(objP));
+
+    if (PyUnicode_Check(objP))
+        return GlueJsonPutString(buf, objP);
+
+    if (PyJsonViewGetJson(objP)) {
+        size_t len;
+        const char* json = json_object_to_json_string_length(
+          PyJsonViewGetJson(objP), JSON_C_TO_STRING_PLAIN, &len);
+        return GlueJsonPut(buf, json, len);
+    }
+
+    if (Py_EnterRecursiveCall(" while serializing a python object to JSON"))
+        return -1;
+
+    if (PyDict_Check(objP)) {
+        PyObject *keyP, *slotP;
+        Py_ssize_t index = 0;
+        int first = 1;
+
+        if (GlueJsonPut(buf, "{", 1) < 0)
+            goto OnExit;
+        while (PyDict_Next(objP, &index, &keyP, &slotP)) {
+            if (!PyUnicode_Check(keyP)) {
+                PyErr_SetString(PyExc_TypeError, "JSON keys should be strings");
+                goto OnExit;
+            }
+            if (!first && GlueJsonPut(buf, ",", 1) < 0)
+                goto OnExit;
+            first = 0;
+            if (GlueJsonPutString(buf, keyP) < 0 ||
+                GlueJsonPut(buf, ":", 1) < 0 ||
+                GlueJsonPutObject(buf, slotP) < 0)
+                goto OnExit;
+        }
+        status = GlueJsonPut(buf, "}", 1);
+
+    } else if (PyList_Check(objP) || PyTuple_Check(objP)) {
+        PyObject** items = PySequence_Fast_ITEMS(objP);
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(objP);
+
+        if (GlueJsonPut(buf, "[", 1) < 0)
+            goto OnExit;
+        for (Py_ssize_t idx = 0; idx < count; idx++) {
+            if (idx && GlueJsonPut(buf, ",", 1) < 0)
+                goto OnExit;
+            if (GlueJsonPutObject(buf, items[idx]) < 0)
+                goto OnExit;
+        }
+        status = GlueJsonPut(buf, "]", 1);
+
+    } else {
+        PyErr_Format(PyExc_TypeError,
+                     "Object of type %s is not JSON serializable",
+                     Py_TYPE(objP)->tp_name);
+    }
+
+OnExit:
+    Py_LeaveRecursiveCall();
+    return status;
+}
+
+// serialize a python object as a zero terminated JSON string to be released
+// with free(). Returns NULL with a python exception set on error.
+char*
+pyObjToJsonString(PyObject* objP, size_t* len)
+{
+    GlueJsonBufT* buf = &glueJsonBuf;
+    char* json;
+
+    buf->len = 0;
+    if (GlueJsonPutObject(buf, objP) < 0) {
+        json = NULL;
+        goto OnExit;
+    }
+
+    json = malloc(buf->len + 1);
+    if (!json) {
+        PyErr_NoMemory();
+        goto OnExit;
+    }
+    memcpy(json, buf->data, buf->len);
+    json[buf->len] = '\0';
+    if (len)
+        *len = buf->len;
+
+OnExit:
+    // do not pin a large buffer on every thread after one large reply
+    if (buf->size > GLUE_JSON_BUF_MAX)
+        GlueJsonBufRelease(buf);
+    return json;
+}
+
+// reply data encoder honoring verb encoding: containers are either sent as
+// json-c trees or as JSON text built by pyObjToJsonString
+bool
+GlueReplyConvert(PyObject* pyArg,
+                 afb_data_t* out,
+                 int index,
+                 GlueEncodingE encoding)
+{
+    size_t len;
+    char* json;
+
+    if (encoding != GLUE_ENCODING_JSON ||
+        !(PyDict_Check(pyArg) || PyList_Check(pyArg) || PyTuple_Check(pyArg) ||
+          PyJsonViewGetJson(pyArg)))
+        return _convert_py_argument_to_afb_data(pyArg, out, index);
+
+    json = pyObjToJsonString(pyArg, &len);
+    if (!json)
+        return false;
+    if (afb_create_data_raw(
+          out, AFB_PREDEFINED_TYPE_JSON, json, len + 1, free, json) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create JSON reply");
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Direct mapped cache of python strings used as dict keys by jsonToPyObj.
+// Payloads sharing a schema reuse the same key objects instead of building
+// them again for each message. Protected by the GIL.
+// ------------------------------------------------------------
+#define GLUE_KEY_CACHE_DEFAULT 256
+#define GLUE_KEY_CACHE_MAX_LEN 64
+
+typedef struct
+{
+    PyObject* keyP;
+    const char* key;
+    size_t len;
+} GlueKeySlotT;
+
+static struct
+{
+    GlueKeySlotT* slots;
+    size_t size; // power of 2, 0 when disabled
+    int initialized;
+    unsigned long hit;
+    unsigned long miss;
+} glueKeyCache;
+
+#ifdef Py_GIL_DISABLED
+static PyMutex glueKeyCacheMutex;
+#endif
+
+static void
+GlueKeyCacheClear(void)
+{
+    for (size_t idx = 0; idx < glueKeyCache.size; idx++)
+        Py_XDECREF(glueKeyCache.slots[idx].keyP);
+    free(glueKeyCache.slots);
+    glueKeyCache.slots = NULL;
+    glueKeyCache.size = 0;
+}
+
+static int
+GlueKeyCacheResize(long size)
+{
+    size_t slots = 0;
+
+    if (size < 0 || size > 1 << 20) {
+        PyErr_SetString(PyExc_ValueError,
+                        "key cache size should be within [0-1048576]");
+        return -1;
+    }
+    GlueKeyCacheClear();
+    glueKeyCache.initialized = 1;
+    if (size == 0)
+        return 0;
+
+    for (slots = 1; slots < (size_t)size; slots <<= 1)
+        ;
+    glueKeyCache.slots = calloc(slots, sizeof(GlueKeySlotT));
+    if (!glueKeyCache.slots) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    glueKeyCache.size = slots;
+    return 0;
+}
+
+// resize the cache to the next power of 2 of size entries, 0 disables it
+int
+GlueKeyCacheSetSize(long size)
+{
+    GLUE_NOGIL_LOCK(glueKeyCacheMutex);
+    int status = GlueKeyCacheResize(size);
+    GLUE_NOGIL_UNLOCK(glueKeyCacheMutex);
+    return status;
+}
+
+PyObject*
+GlueKeyCacheStats(void)
+{
+    GLUE_NOGIL_LOCK(glueKeyCacheMutex);
+    PyObject* statsP = Py_BuildValue("{s:n,s:k,s:k}",
+                                     "size",
+                                     (Py_ssize_t)glueKeyCache.size,
+                                     "hit",
+                                     glueKeyCache.hit,
+                                     "miss",
+                                     glueKeyCache.miss);
+    GLUE_NOGIL_UNLOCK(glueKeyCacheMutex);
+    return statsP;
+}
+
+static PyObject*
+GlueKeyCacheLookup(const char* key)
+{
+    uint32_t hash = 2166136261u;
+    size_t len;
+
+    if (!glueKeyCache.initialized &&
+        GlueKeyCacheResize(GLUE_KEY_CACHE_DEFAULT) < 0)
+        PyErr_Clear();
+    if (!glueKeyCache.size)
+        return PyUnicode_FromString(key);
+
+    for (len = 0; key[len]; len++) {
+        if (len == GLUE_KEY_CACHE_MAX_LEN)
+            return PyUnicode_FromString(key);
+        hash = (hash ^ (unsigned char)key[len]) * 16777619u;
+    }
+
+    GlueKeySlotT* slot = &glueKeyCache.slots[hash & (glueKeyCache.size - 1)];
+    if (slot->keyP && slot->len == len && !memcmp(slot->key, key, len)) {
+        glueKeyCache.hit++;
+        return AFB_Py_NewRef(slot->keyP);
+    }
+
+    glueKeyCache.miss++;
+    PyObject* keyP = PyUnicode_FromStringAndSize(key, (Py_ssize_t)len);
+    if (!keyP)
+        return NULL;
+
+    // utf8 buffer is owned by the string, it lives as long as the slot
+    const char* utf8 = PyUnicode_AsUTF8(keyP);
+    if (!utf8) {
+        PyErr_Clear();
+        return keyP;
+    }
+    Py_XDECREF(slot->keyP);
+    slot->keyP = AFB_Py_NewRef(keyP);
+    slot->key = utf8;
+    slot->len = len;
+    return keyP;
+}
+
+// return a new reference on the python string for key
+static PyObject*
+GlueKeyCacheGet(const char* key)
+{
+    GLUE_NOGIL_LOCK(glueKeyCacheMutex);
+    PyObject* keyP = GlueKeyCacheLookup(key);
+    GLUE_NOGIL_UNLOCK(glueKeyCacheMutex);
+    return keyP;
+}
+
 // Move from json_object to pythopn object representation
 PyObject*
 jsonToPyObj(json_object* argsJ)
@@ -538,7 +1885,7 @@ jsonToPyObj(json_object* argsJ)
             json_object_object_foreach(argsJ, key, valJ)
             {
                 PyObject* valP = jsonToPyObj(valJ);
-                PyObject* keyP = PyUnicode_FromString(key);
+                PyObject* keyP = GlueKeyCacheGet(key);
                 if (!valP || !keyP) {
                     Py_XDECREF(valP);
                     Py_XDECREF(keyP);
@@ -598,77 +1945,1545 @@ OnErrorExit:
     return NULL;
 }
 
+// ------------------------------------------------------------
+// libafb.JsonView: read-only mapping/sequence over a json_object. Only the
+// accessed children are converted, containers being returned as new views.
+// ------------------------------------------------------------
+typedef struct
+{
+    PyObject_HEAD json_object* json;
+} PyJsonViewObjectT;
+
+PyObject*
+PyJsonViewNew(json_object* valueJ)
+{
+    json_type jtype = json_object_get_type(valueJ);
+    if (jtype != json_type_object && jtype != json_type_array)
+        return jsonToPyObj(valueJ);
+
+    PyJsonViewObjectT* viewP =
+      PyObject_New(PyJsonViewObjectT, &PyJsonViewType);
+    if (!viewP)
+        return NULL;
+    viewP->json = json_object_get(valueJ);
+    return (PyObject*)viewP;
+}
+
+json_object*
+PyJsonViewGetJson(PyObject* objP)
+{
+    if (Py_TYPE(objP) != &PyJsonViewType)
+        return NULL;
+    return ((PyJsonViewObjectT*)objP)->json;
+}
+
 static void
-PyRqtFree(void* userdata)
+PyJsonViewFreeCb(PyObject* self)
 {
-    GlueHandleT* glue = (GlueHandleT*)userdata;
-    assert(glue && (glue->magic == GLUE_RQT_MAGIC_TAG));
+    json_object_put(((PyJsonViewObjectT*)self)->json);
+    Py_TYPE(self)->tp_free(self);
+}
 
-    free(glue);
-    return;
+static int
+PyJsonViewIsObject(PyObject* self)
+{
+    return json_object_is_type(((PyJsonViewObjectT*)self)->json,
+                               json_type_object);
 }
 
-// add a reference on Glue handle
-void
-PyRqtAddref(GlueHandleT* glue)
+static Py_ssize_t
+PyJsonViewLenCb(PyObject* self)
 {
-    if (glue->magic == GLUE_RQT_MAGIC_TAG) {
-        afb_req_addref(glue->rqt.afb);
-    }
+    json_object* valueJ = ((PyJsonViewObjectT*)self)->json;
+    if (PyJsonViewIsObject(self))
+        return (Py_ssize_t)json_object_object_length(valueJ);
+    return (Py_ssize_t)json_object_array_length(valueJ);
 }
 
-// add a reference on Glue handle
-void
-PyRqtUnref(GlueHandleT* glue)
+static PyObject*
+PyJsonViewItemCb(PyObject* self, Py_ssize_t index)
 {
-    if (glue->magic == GLUE_RQT_MAGIC_TAG) {
-        afb_req_unref(glue->rqt.afb);
+    json_object* valueJ = ((PyJsonViewObjectT*)self)->json;
+    Py_ssize_t length = (Py_ssize_t)json_object_array_length(valueJ);
+
+    if (index < 0)
+        index += length;
+    if (index < 0 || index >= length) {
+        PyErr_SetString(PyExc_IndexError, "JsonView index out of range");
+        return NULL;
     }
+    return PyJsonViewNew(json_object_array_get_idx(valueJ, (size_t)index));
 }
 
-// allocate and push a py request handle
-GlueHandleT*
-PyRqtNew(afb_req_t afbRqt)
+static PyObject*
+PyJsonViewGetCb(PyObject* self, PyObject* keyP)
 {
-    assert(afbRqt);
+    json_object* slotJ;
 
-    GlueHandleT* glue = (GlueHandleT*)calloc(1, sizeof(GlueHandleT));
-    if (glue != NULL) {
-        glue->magic = GLUE_RQT_MAGIC_TAG;
-        glue->rqt.afb = afbRqt;
+    if (!PyJsonViewIsObject(self)) {
+        if (!PyIndex_Check(keyP)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "JsonView indices must be integers");
+            return NULL;
+        }
+        Py_ssize_t index = PyNumber_AsSsize_t(keyP, PyExc_IndexError);
+        if (index == -1 && PyErr_Occurred())
+            return NULL;
+        return PyJsonViewItemCb(self, index);
+    }
 
-        // add py rqt handle to afb request livecycle
-        afb_req_v4_set_userdata(afbRqt, (void*)glue, PyRqtFree);
+    if (!PyUnicode_Check(keyP)) {
+        PyErr_SetObject(PyExc_KeyError, keyP);
+        return NULL;
     }
-    return glue;
+    const char* key = PyUnicode_AsUTF8(keyP);
+    if (!key)
+        return NULL;
+    if (!json_object_object_get_ex(
+          ((PyJsonViewObjectT*)self)->json, key, &slotJ)) {
+        PyErr_SetObject(PyExc_KeyError, keyP);
+        return NULL;
+    }
+    return PyJsonViewNew(slotJ);
 }
 
-// reply afb request only once and unref py handle
-int
-GlueAfbReply(GlueHandleT* glue, long status, long nbreply, afb_data_t* reply)
+// full conversion to python dict/list
+static PyObject*
+PyJsonViewCopyCb(PyObject* self, PyObject* Py_UNUSED(ignored))
 {
-    if (glue->rqt.replied)
-        goto OnErrorExit;
-
-    Py_BEGIN_ALLOW_THREADS afb_req_reply(
-      glue->rqt.afb, (int)status, (int)nbreply, reply);
-    Py_END_ALLOW_THREADS
+    return jsonToPyObj(((PyJsonViewObjectT*)self)->json);
+}
 
-      glue->rqt.replied = 1;
-    return 0;
+static PyObject*
+PyJsonViewKeysCb(PyObject* self, PyObject* Py_UNUSED(ignored))
+{
+    if (!PyJsonViewIsObject(self)) {
+        PyErr_SetString(PyExc_TypeError, "JsonView array has no keys");
+        return NULL;
+    }
 
-OnErrorExit:
-    GLUE_DBG_ERROR(glue, "unique response require");
-    return -1;
+    PyObject* keysP = PyList_New(0);
+    if (!keysP)
+        return NULL;
+    json_object_object_foreach(((PyJsonViewObjectT*)self)->json, key, valJ)
+    {
+        (void)valJ;
+        PyObject* keyP = PyUnicode_FromString(key);
+        if (!keyP || PyList_Append(keysP, keyP) < 0) {
+            Py_XDECREF(keyP);
+            Py_DECREF(keysP);
+            return NULL;
+        }
+        Py_DECREF(keyP);
+    }
+    return keysP;
 }
 
-char*
-pyObjToStr(PyObject* objP)
+static PyObject*
+PyJsonViewGetMethod(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
 {
-    Py_ssize_t sz;
-    const char* cstr = PyUnicode_AsUTF8AndSize(objP, &sz);
-    char* str = cstr == NULL ? NULL : malloc((size_t)(++sz));
+    if (nargs < 1 || nargs > 2) {
+        PyErr_SetString(PyExc_TypeError, "syntax: view.get(key, [default])");
+        return NULL;
+    }
+
+    PyObject* resultP = PyJsonViewGetCb(self, argsP[0]);
+    if (!resultP && (PyErr_ExceptionMatches(PyExc_KeyError) ||
+                     PyErr_ExceptionMatches(PyExc_IndexError))) {
+        PyErr_Clear();
+        resultP = AFB_Py_NewRef(nargs == 2 ? argsP[1] : Py_None);
+    }
+    return resultP;
+}
+
+static int
+PyJsonViewContainsCb(PyObject* self, PyObject* keyP)
+{
+    if (PyJsonViewIsObject(self)) {
+        const char* key = PyUnicode_Check(keyP) ? PyUnicode_AsUTF8(keyP) : NULL;
+        if (!key)
+            return PyErr_Occurred() ? -1 : 0;
+        return json_object_object_get_ex(
+          ((PyJsonViewObjectT*)self)->json, key, NULL);
+    }
+
+    for (Py_ssize_t idx = 0; idx < PyJsonViewLenCb(self); idx++) {
+        PyObject* itemP = PyJsonViewItemCb(self, idx);
+        if (!itemP)
+            return -1;
+        int found = PyObject_RichCompareBool(itemP, keyP, Py_EQ);
+        Py_DECREF(itemP);
+        if (found)
+            return found;
+    }
+    return 0;
+}
+
+// objects iterate on their keys, arrays on their items
+static PyObject*
+PyJsonViewIterCb(PyObject* self)
+{
+    PyObject *listP, *iterP;
+
+    if (PyJsonViewIsObject(self)) {
+        listP = PyJsonViewKeysCb(self, NULL);
+    } else {
+        Py_ssize_t length = PyJsonViewLenCb(self);
+        listP = PyList_New(length);
+        for (Py_ssize_t idx = 0; listP && idx < length; idx++) {
+            PyObject* itemP = PyJsonViewItemCb(self, idx);
+            if (!itemP) {
+                Py_CLEAR(listP);
+                break;
+            }
+            PyList_SET_ITEM(listP, idx, itemP);
+        }
+    }
+    if (!listP)
+        return NULL;
+    iterP = PyObject_GetIter(listP);
+    Py_DECREF(listP);
+    return iterP;
+}
+
+static PyObject*
+PyJsonViewCompareCb(PyObject* self, PyObject* otherP, int op)
+{
+    PyObject *leftP, *rightP, *resultP;
+
+    if (op != Py_EQ && op != Py_NE)
+        Py_RETURN_NOTIMPLEMENTED;
+
+    leftP = PyJsonViewCopyCb(self, NULL);
+    if (!leftP)
+        return NULL;
+    rightP = Py_TYPE(otherP) == &PyJsonViewType ? PyJsonViewCopyCb(otherP, NULL)
+                                               : AFB_Py_NewRef(otherP);
+    if (!rightP) {
+        Py_DECREF(leftP);
+        return NULL;
+    }
+    resultP = PyObject_RichCompare(leftP, rightP, op);
+    Py_DECREF(leftP);
+    Py_DECREF(rightP);
+    return resultP;
+}
+
+static PyObject*
+PyJsonViewReprCb(PyObject* self)
+{
+    return PyUnicode_FromFormat(
+      "JsonView(%s)",
+      json_object_to_json_string(((PyJsonViewObjectT*)self)->json));
+}
+
+static PyMappingMethods PyJsonViewMapping = {
+    .mp_length = PyJsonViewLenCb,
+    .mp_subscript = PyJsonViewGetCb,
+};
+
+static PySequenceMethods PyJsonViewSequence = {
+    .sq_contains = PyJsonViewContainsCb,
+};
+
+static PyMethodDef PyJsonViewMethods[] = {
+    { "get",
+      (PyCFunction)(void (*)(void))PyJsonViewGetMethod,
+      METH_FASTCALL,
+      "value of key/index or default" },
+    { "keys", PyJsonViewKeysCb, METH_NOARGS, "list of object keys" },
+    { "copy", PyJsonViewCopyCb, METH_NOARGS, "convert to python dict/list" },
+    { NULL }
+};
+
+PyTypeObject PyJsonViewType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "libafb.JsonView",
+    .tp_doc = "Lazy read-only view on a JSON object or array",
+    .tp_basicsize = sizeof(PyJsonViewObjectT),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = PyJsonViewFreeCb,
+    .tp_repr = PyJsonViewReprCb,
+    .tp_as_mapping = &PyJsonViewMapping,
+    .tp_as_sequence = &PyJsonViewSequence,
+    .tp_iter = PyJsonViewIterCb,
+    .tp_richcompare = PyJsonViewCompareCb,
+    .tp_methods = PyJsonViewMethods,
+};
+
+// ------------------------------------------------------------
+// asyncio bridge. libafb does not expose its main loop file descriptor, so
+// the bridge loop runs in its own thread and libafb callbacks hand results
+// over with call_soon_threadsafe. Should be called with the GIL held.
+// ------------------------------------------------------------
+static PyObject* glueAioModule;
+static PyObject* glueAioLoop;
+static PyObject* glueAioSetFunc;
+
+#ifdef Py_GIL_DISABLED
+static PyMutex glueAioMutex;
+#endif
+
+static PyObject*
+GlueAioImport(void)
+{
+    GLUE_NOGIL_LOCK(glueAioMutex);
+    if (!glueAioModule)
+        glueAioModule = PyImport_ImportModule("asyncio");
+    GLUE_NOGIL_UNLOCK(glueAioMutex);
+    return glueAioModule;
+}
+
+// return a borrowed reference on the bridge loop, started on first use
+PyObject*
+GlueAioLoop(void)
+{
+    PyObject *threadingP = NULL, *classP = NULL, *runP = NULL;
+    PyObject *argsP = NULL, *kwargsP = NULL, *threadP = NULL, *loopP = NULL;
+
+    if (!GlueAioImport())
+        return NULL;
+    GLUE_NOGIL_LOCK(glueAioMutex);
+    if (glueAioLoop)
+        goto OnExit;
+
+    loopP = PyObject_CallMethod(glueAioModule, "new_event_loop", NULL);
+    threadingP = PyImport_ImportModule("threading");
+    if (!loopP || !threadingP)
+        goto OnExit;
+
+    // threading.Thread(target=loop.run_forever, name=..., daemon=True)
+    classP = PyObject_GetAttrString(threadingP, "Thread");
+    runP = PyObject_GetAttrString(loopP, "run_forever");
+    if (!classP || !runP)
+        goto OnExit;
+    argsP = PyTuple_New(0);
+    kwargsP = Py_BuildValue(
+      "{s:O,s:s,s:O}", "target", runP, "name", "afb-asyncio", "daemon", Py_True);
+    if (!argsP || !kwargsP)
+        goto OnExit;
+    threadP = PyObject_Call(classP, argsP, kwargsP);
+    if (!threadP)
+        goto OnExit;
+    PyObject* startP = PyObject_CallMethod(threadP, "start", NULL);
+    if (!startP)
+        goto OnExit;
+    Py_DECREF(startP);
+
+    glueAioLoop = loopP;
+    loopP = NULL;
+
+OnExit:
+    Py_XDECREF(threadingP);
+    Py_XDECREF(classP);
+    Py_XDECREF(runP);
+    Py_XDECREF(argsP);
+    Py_XDECREF(kwargsP);
+    Py_XDECREF(threadP);
+    Py_XDECREF(loopP);
+    GLUE_NOGIL_UNLOCK(glueAioMutex);
+    return glueAioLoop;
+}
+
+// runs within the future loop: set result unless future was cancelled
+static PyObject*
+GlueAioSetResult(PyObject* self, PyObject* const* argsP, Py_ssize_t nargs)
+{
+    PyObject* doneP = PyObject_CallMethod(argsP[0], "done", NULL);
+    if (!doneP)
+        return NULL;
+    int done = PyObject_IsTrue(doneP);
+    Py_DECREF(doneP);
+    if (done)
+        Py_RETURN_NONE;
+    return PyObject_CallMethod(argsP[0], "set_result", "O", argsP[1]);
+}
+
+static PyMethodDef GlueAioSetDef = {
+    "_aiosetresult",
+    (PyCFunction)(void (*)(void))GlueAioSetResult,
+    METH_FASTCALL,
+    "set future result from its loop",
+};
+
+// resolve an asyncio future from any thread
+int
+GlueAioResolve(PyObject* futureP, PyObject* resultP)
+{
+    PyObject *loopP, *statusP;
+
+    GLUE_NOGIL_LOCK(glueAioMutex);
+    if (!glueAioSetFunc)
+        glueAioSetFunc = PyCFunction_New(&GlueAioSetDef, NULL);
+    GLUE_NOGIL_UNLOCK(glueAioMutex);
+    if (!glueAioSetFunc)
+        return -1;
+
+    loopP = PyObject_CallMethod(futureP, "get_loop", NULL);
+    if (!loopP)
+        return -1;
+    statusP = PyObject_CallMethod(loopP,
+                                  "call_soon_threadsafe",
+                                  "OOO",
+                                  glueAioSetFunc,
+                                  futureP,
+                                  resultP);
+    Py_DECREF(loopP);
+    if (!statusP)
+        return -1;
+    Py_DECREF(statusP);
+    return 0;
+}
+
+// create a future on the running loop of the calling coroutine
+PyObject*
+GlueAioFutureNew(void)
+{
+    if (!GlueAioImport())
+        return NULL;
+    PyObject* loopP =
+      PyObject_CallMethod(glueAioModule, "get_running_loop", NULL);
+    if (!loopP)
+        return NULL;
+    PyObject* futureP = PyObject_CallMethod(loopP, "create_future", NULL);
+    Py_DECREF(loopP);
+    return futureP;
+}
+
+// schedule a coroutine on the bridge loop, returns a concurrent future
+PyObject*
+GlueAioRun(PyObject* coroP)
+{
+    PyObject* loopP = GlueAioLoop();
+    if (!loopP)
+        return NULL;
+    return PyObject_CallMethod(
+      glueAioModule, "run_coroutine_threadsafe", "OO", coroP, loopP);
+}
+
+// Per-thread free-lists recycling request and call handles. Items released
+// from a thread land in this thread cache, whatever thread allocated them;
+// caches are bounded and given back to the system when the thread exits.
+#define GLUE_POOL_MAX_CACHED 64
+
+typedef struct GluePoolItemS
+{
+    struct GluePoolItemS* next;
+} GluePoolItemT;
+
+typedef struct
+{
+    GluePoolItemT* head;
+    unsigned count;
+} GluePoolCacheT;
+
+typedef struct
+{
+    const char* uid;
+    size_t size;
+    unsigned long hit;
+    unsigned long miss;
+    unsigned long recycle;
+    unsigned long release;
+} GluePoolT;
+
+static GluePoolT gluePools[GLUE_POOL_COUNT] = {
+    [GLUE_POOL_RQT] = { .uid = "rqt", .size = sizeof(GlueHandleT) },
+    [GLUE_POOL_CALL] = { .uid = "call", .size = sizeof(GlueCallHandleT) },
+    [GLUE_POOL_DATA] = { .uid = "data",
+                         .size = GLUE_DATA_POOLED * sizeof(afb_data_t) },
+};
+static __thread GluePoolCacheT gluePoolCaches[GLUE_POOL_COUNT];
+static __thread int gluePoolHooked;
+static pthread_key_t gluePoolKey;
+static pthread_once_t gluePoolOnce = PTHREAD_ONCE_INIT;
+
+static void
+GluePoolThreadExit(void* userdata)
+{
+    GluePoolCacheT* caches = (GluePoolCacheT*)userdata;
+    for (int idx = 0; idx < GLUE_POOL_COUNT; idx++) {
+        while (caches[idx].head) {
+            GluePoolItemT* item = caches[idx].head;
+            caches[idx].head = item->next;
+            free(item);
+            GLUE_COUNTER_INC(gluePools[idx].release);
+        }
+        caches[idx].count = 0;
+    }
+}
+
+static void
+GluePoolKeyInit(void)
+{
+    pthread_key_create(&gluePoolKey, GluePoolThreadExit);
+}
+
+// return a zeroed item from calling thread cache or from the system
+void*
+GluePoolAlloc(GluePoolE pool)
+{
+    GluePoolCacheT* cache = &gluePoolCaches[pool];
+    GluePoolItemT* item = cache->head;
+
+    if (item) {
+        cache->head = item->next;
+        cache->count--;
+        GLUE_COUNTER_INC(gluePools[pool].hit);
+        memset(item, 0, gluePools[pool].size);
+        return item;
+    }
+
+    GLUE_COUNTER_INC(gluePools[pool].miss);
+    return calloc(1, gluePools[pool].size);
+}
+
+// push back item within calling thread cache, release it when cache is full
+void
+GluePoolFree(GluePoolE pool, void* userdata)
+{
+    GluePoolCacheT* cache = &gluePoolCaches[pool];
+    GluePoolItemT* item = (GluePoolItemT*)userdata;
+
+    if (!item)
+        return;
+
+    if (cache->count >= GLUE_POOL_MAX_CACHED) {
+        GLUE_COUNTER_INC(gluePools[pool].release);
+        free(item);
+        return;
+    }
+
+    // register thread exit hook on first cached item
+    if (!gluePoolHooked) {
+        pthread_once(&gluePoolOnce, GluePoolKeyInit);
+        pthread_setspecific(gluePoolKey, gluePoolCaches);
+        gluePoolHooked = 1;
+    }
+    item->next = cache->head;
+    cache->head = item;
+    cache->count++;
+    GLUE_COUNTER_INC(gluePools[pool].recycle);
+}
+
+// return a zeroed array of count afb_data_t, count should not be null
+afb_data_t*
+GlueDataAlloc(size_t count)
+{
+    if (count <= GLUE_DATA_POOLED)
+        return GluePoolAlloc(GLUE_POOL_DATA);
+    return calloc(count, sizeof(afb_data_t));
+}
+
+// release an array from GlueDataAlloc, data are not unreferenced
+void
+GlueDataFree(afb_data_t* data, size_t count)
+{
+    if (count <= GLUE_DATA_POOLED)
+        GluePoolFree(GLUE_POOL_DATA, data);
+    else
+        free(data);
+}
+
+// prepare count zeroed slots, return NULL when out of memory
+afb_data_t*
+GlueDataArrayInit(GlueDataArrayT* array, size_t count)
+{
+    array->count = count;
+    if (count <= GLUE_DATA_INLINE) {
+        memset(array->inlined, 0, sizeof(array->inlined));
+        array->data = array->inlined;
+    } else {
+        array->data = GlueDataAlloc(count);
+    }
+    return array->data;
+}
+
+void
+GlueDataArrayRelease(GlueDataArrayT* array)
+{
+    if (array->data && array->data != array->inlined)
+        GlueDataFree(array->data, array->count);
+    array->data = NULL;
+}
+
+// return pools counters as a python dict {uid: {hit, miss, recycle, release}}
+PyObject*
+GluePoolStats(void)
+{
+    PyObject* statsP = PyDict_New();
+    if (!statsP)
+        return NULL;
+
+    for (int idx = 0; idx < GLUE_POOL_COUNT; idx++) {
+        GluePoolT* pool = &gluePools[idx];
+        PyObject* poolP = Py_BuildValue(
+          "{s:k,s:k,s:k,s:k}",
+          "hit",
+          __atomic_load_n(&pool->hit, __ATOMIC_RELAXED),
+          "miss",
+          __atomic_load_n(&pool->miss, __ATOMIC_RELAXED),
+          "recycle",
+          __atomic_load_n(&pool->recycle, __ATOMIC_RELAXED),
+          "release",
+          __atomic_load_n(&pool->release, __ATOMIC_RELAXED));
+        if (!poolP || PyDict_SetItemString(statsP, pool->uid, poolP) < 0) {
+            Py_XDECREF(poolP);
+            Py_DECREF(statsP);
+            return NULL;
+        }
+        Py_DECREF(poolP);
+    }
+    return statsP;
+}
+
+// ------------------------------------------------------------
+// GIL instrumentation: every callback entry point records how long it
+// waited for the GIL and how long it held it, globally and per verb.
+// Histograms are only updated with relaxed atomics.
+// ------------------------------------------------------------
+static const char* glueGilUids[GLUE_GIL_COUNT] = {
+    [GLUE_GIL_VERB] = "verb",         [GLUE_GIL_EVENT] = "event",
+    [GLUE_GIL_CONTROL] = "control",   [GLUE_GIL_STARTUP] = "startup",
+    [GLUE_GIL_CALLBACK] = "callback", [GLUE_GIL_FUTURE] = "future",
+    [GLUE_GIL_RELEASE] = "release",   [GLUE_GIL_TIMER] = "timer",
+};
+
+static struct
+{
+    GlueHistoT wait;
+    GlueHistoT hold;
+} glueGilStats[GLUE_GIL_COUNT];
+
+uint64_t
+GlueNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+// values below 2^GLUE_HISTO_SUB_BITS have their own bucket, above the
+// exponent selects a group and the next bits a linear sub-bucket
+static unsigned
+GlueHistoBucket(uint64_t ns)
+{
+    if (ns < (1u << GLUE_HISTO_SUB_BITS))
+        return (unsigned)ns;
+
+    unsigned exp = 63 - (unsigned)__builtin_clzll(ns);
+    if (exp >= GLUE_HISTO_MAX_BITS)
+        return GLUE_HISTO_BUCKETS - 1;
+    unsigned shift = exp - GLUE_HISTO_SUB_BITS;
+    unsigned sub = (unsigned)(ns >> shift) & ((1u << GLUE_HISTO_SUB_BITS) - 1);
+    return ((shift + 1) << GLUE_HISTO_SUB_BITS) + sub;
+}
+
+// exclusive upper bound of a bucket
+static uint64_t
+GlueHistoBound(unsigned bucket)
+{
+    if (bucket < (1u << GLUE_HISTO_SUB_BITS))
+        return bucket + 1;
+
+    unsigned shift = (bucket >> GLUE_HISTO_SUB_BITS) - 1;
+    uint64_t sub = bucket & ((1u << GLUE_HISTO_SUB_BITS) - 1);
+    return ((1ull << GLUE_HISTO_SUB_BITS) + sub + 1) << shift;
+}
+
+void
+GlueHistoAdd(GlueHistoT* histo, uint64_t ns)
+{
+    unsigned bucket = GlueHistoBucket(ns);
+
+    GLUE_COUNTER_INC(histo->count);
+    __atomic_fetch_add(&histo->total, (unsigned long)ns, __ATOMIC_RELAXED);
+    GLUE_COUNTER_INC(histo->buckets[bucket]);
+
+    unsigned long max = __atomic_load_n(&histo->max, __ATOMIC_RELAXED);
+    while (ns > max && !__atomic_compare_exchange_n(&histo->max,
+                                                    &max,
+                                                    (unsigned long)ns,
+                                                    true,
+                                                    __ATOMIC_RELAXED,
+                                                    __ATOMIC_RELAXED))
+        ;
+}
+
+// upper bound of the bucket holding the given percentile, capped by max
+static unsigned long
+GlueHistoPercentile(const unsigned long* buckets,
+                    unsigned long count,
+                    unsigned long max,
+                    unsigned percent)
+{
+    unsigned long rank = (count * percent + 99) / 100, seen = 0;
+    for (unsigned idx = 0; idx < GLUE_HISTO_BUCKETS; idx++) {
+        seen += buckets[idx];
+        if (seen >= rank && seen) {
+            uint64_t bound = GlueHistoBound(idx);
+            return bound < max ? (unsigned long)bound : max;
+        }
+    }
+    return 0;
+}
+
+// {count, total, max, p50, p90, p99, buckets}, durations in ns. buckets
+// lists [upper bound, count] of non empty buckets.
+json_object*
+GlueHistoJson(GlueHistoT* histo)
+{
+    unsigned long buckets[GLUE_HISTO_BUCKETS], count = 0;
+    unsigned long max = __atomic_load_n(&histo->max, __ATOMIC_RELAXED);
+
+    json_object* histoJ = json_object_new_object();
+    json_object* bucketsJ = json_object_new_array();
+    for (unsigned idx = 0; idx < GLUE_HISTO_BUCKETS; idx++) {
+        buckets[idx] = __atomic_load_n(&histo->buckets[idx], __ATOMIC_RELAXED);
+        if (!buckets[idx])
+            continue;
+        count += buckets[idx];
+        json_object* bucketJ = json_object_new_array_ext(2);
+        json_object_array_add(
+          bucketJ, json_object_new_int64((int64_t)GlueHistoBound(idx)));
+        json_object_array_add(bucketJ, json_object_new_int64(buckets[idx]));
+        json_object_array_add(bucketsJ, bucketJ);
+    }
+
+    json_object_object_add(histoJ, "count", json_object_new_int64(count));
+    json_object_object_add(
+      histoJ,
+      "total",
+      json_object_new_int64(__atomic_load_n(&histo->total, __ATOMIC_RELAXED)));
+    json_object_object_add(histoJ, "max", json_object_new_int64(max));
+    json_object_object_add(
+      histoJ,
+      "p50",
+      json_object_new_int64(GlueHistoPercentile(buckets, count, max, 50)));
+    json_object_object_add(
+      histoJ,
+      "p90",
+      json_object_new_int64(GlueHistoPercentile(buckets, count, max, 90)));
+    json_object_object_add(
+      histoJ,
+      "p99",
+      json_object_new_int64(GlueHistoPercentile(buckets, count, max, 99)));
+    json_object_object_add(histoJ, "buckets", bucketsJ);
+    return histoJ;
+}
+
+void
+GlueGilEnsure(GlueGilT* gil, GlueGilPointE point)
+{
+    gil->point = point;
+    gil->entered = GlueNowNs();
+    gil->state = PyGILState_Ensure();
+    gil->acquired = GlueNowNs();
+}
+
+// verb, when not NULL, also accounts the durations to the verb
+void
+GlueGilRelease(GlueGilT* gil, GlueVerbT* verb)
+{
+    uint64_t wait = gil->acquired - gil->entered;
+    uint64_t hold = GlueNowNs() - gil->acquired;
+
+    PyGILState_Release(gil->state);
+    GlueHistoAdd(&glueGilStats[gil->point].wait, wait);
+    GlueHistoAdd(&glueGilStats[gil->point].hold, hold);
+    if (verb) {
+        GlueHistoAdd(&verb->gilWait, wait);
+        GlueHistoAdd(&verb->gilHold, hold);
+    }
+}
+
+static json_object*
+GlueGilJson(GlueHistoT* wait, GlueHistoT* hold)
+{
+    json_object* gilJ = json_object_new_object();
+    json_object_object_add(gilJ, "wait", GlueHistoJson(wait));
+    json_object_object_add(gilJ, "hold", GlueHistoJson(hold));
+    return gilJ;
+}
+
+// {'gil': {entry: {wait, hold}}} plus per verb counters and histograms
+// {'verbs': {verb: {calls, errors, latency, convert, exec, encode, gil}}}
+// when an api is given
+json_object*
+GlueStatsJson(afb_api_t apiv4)
+{
+    json_object* statsJ = json_object_new_object();
+    json_object* gilJ = json_object_new_object();
+    for (int idx = 0; idx < GLUE_GIL_COUNT; idx++) {
+        json_object_object_add(
+          gilJ,
+          glueGilUids[idx],
+          GlueGilJson(&glueGilStats[idx].wait, &glueGilStats[idx].hold));
+    }
+    json_object_object_add(statsJ, "gil", gilJ);
+    if (!apiv4)
+        return statsJ;
+
+    json_object* verbsJ = json_object_new_object();
+    for (unsigned idx = 0; idx < afb_api_v4_verb_count(apiv4); idx++) {
+        const afb_verb_t* afbVerb = afb_api_v4_verb_at(apiv4, idx);
+        if (!afbVerb)
+            break;
+        if (afbVerb->callback != GlueApiVerbCb)
+            continue;
+        AfbVcbDataT* vcbData = afbVerb->vcbdata;
+        GlueVerbT* verb = __atomic_load_n(&vcbData->callback, __ATOMIC_ACQUIRE);
+        if (vcbData->magic != (void*)AfbAddVerbs || !verb)
+            continue;
+
+        json_object* verbJ = json_object_new_object();
+        json_object_object_add(
+          verbJ,
+          "calls",
+          json_object_new_int64(
+            __atomic_load_n(&verb->calls, __ATOMIC_RELAXED)));
+        json_object_object_add(
+          verbJ,
+          "errors",
+          json_object_new_int64(
+            __atomic_load_n(&verb->errors, __ATOMIC_RELAXED)));
+        json_object_object_add(
+          verbJ, "latency", GlueHistoJson(&verb->latency));
+        json_object_object_add(
+          verbJ, "convert", GlueHistoJson(&verb->convert));
+        json_object_object_add(verbJ, "exec", GlueHistoJson(&verb->exec));
+        json_object_object_add(verbJ, "encode", GlueHistoJson(&verb->encode));
+        json_object_object_add(
+          verbJ, "gil", GlueGilJson(&verb->gilWait, &verb->gilHold));
+        json_object_object_add(verbsJ, verb->verb, verbJ);
+    }
+    json_object_object_add(statsJ, "verbs", verbsJ);
+    return statsJ;
+}
+
+static void
+PyRqtFree(void* userdata)
+{
+    GlueHandleT* glue = (GlueHandleT*)userdata;
+    assert(glue && (glue->magic == GLUE_RQT_MAGIC_TAG));
+
+    GluePoolFree(GLUE_POOL_RQT, glue);
+    return;
+}
+
+// add a reference on Glue handle
+void
+PyRqtAddref(GlueHandleT* glue)
+{
+    if (glue->magic == GLUE_RQT_MAGIC_TAG) {
+        afb_req_addref(glue->rqt.afb);
+    }
+}
+
+// add a reference on Glue handle
+void
+PyRqtUnref(GlueHandleT* glue)
+{
+    if (glue->magic == GLUE_RQT_MAGIC_TAG) {
+        afb_req_unref(glue->rqt.afb);
+    }
+}
+
+// allocate and push a py request handle
+GlueHandleT*
+PyRqtNew(afb_req_t afbRqt)
+{
+    assert(afbRqt);
+
+    GlueHandleT* glue = (GlueHandleT*)GluePoolAlloc(GLUE_POOL_RQT);
+    if (glue != NULL) {
+        glue->magic = GLUE_RQT_MAGIC_TAG;
+        glue->rqt.afb = afbRqt;
+
+        // add py rqt handle to afb request livecycle
+        afb_req_v4_set_userdata(afbRqt, (void*)glue, PyRqtFree);
+    }
+    return glue;
+}
+
+// reply afb request only once and unref py handle
+int
+GlueAfbReply(GlueHandleT* glue, long status, long nbreply, afb_data_t* reply)
+{
+    if (glue->rqt.replied)
+        goto OnErrorExit;
+
+    Py_BEGIN_ALLOW_THREADS afb_req_reply(
+      glue->rqt.afb, (int)status, (int)nbreply, reply);
+    Py_END_ALLOW_THREADS
+
+      glue->rqt.replied = 1;
+    if (glue->rqt.verb)
+        GlueHistoAdd(&glue->rqt.verb->latency,
+                     GlueNowNs() - glue->rqt.arrival);
+    return 0;
+
+OnErrorExit:
+    GLUE_DBG_ERROR(glue, "unique response require");
+    return -1;
+}
+
+char*
+pyObjToStr(PyObject* objP)
+{
+    Py_ssize_t sz;
+    const char* cstr = PyUnicode_AsUTF8AndSize(objP, &sz);
+    char* str = cstr == NULL ? NULL : malloc((size_t)(++sz));
     if (str != NULL)
         memcpy(str, cstr, sz);
     return str;
 }
+
+// asynchronous log pipeline: each producer thread owns a single producer,
+// single consumer ring drained in batches by one background thread.
+typedef struct
+{
+    afb_api_t api;
+    int level;
+    int line;
+    char func[GLUE_LOG_FUNC];
+    char* heap; /**< long text, released by the drain thread */
+    char text[GLUE_LOG_TEXT];
+} GlueLogRecT;
+
+typedef struct GlueLogRingS
+{
+    struct GlueLogRingS* next;
+    unsigned long head; /**< written by the producer thread only */
+    unsigned long tail; /**< written by the drain thread only */
+    unsigned long dropped;
+    unsigned long mask;
+    int dead; /**< producer thread exited */
+    GlueLogRecT recs[];
+} GlueLogRingT;
+
+static struct
+{
+    pthread_mutex_t mutex; /**< rings list and drain counters */
+    GlueLogRingT* rings;
+    unsigned long slots; /**< ring size for new threads, 0 when off */
+    int running;
+    int hooked;
+    unsigned long queued;  /**< records of released rings */
+    unsigned long dropped; /**< dropped records of released rings */
+    unsigned long drained;
+    unsigned long batches;
+    unsigned long truncated; /**< long text cut when out of memory */
+    unsigned long rqtid;
+} glueLog = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+
+static __thread GlueLogRingT* glueLogRing;
+static pthread_key_t glueLogKey;
+static pthread_once_t glueLogOnce = PTHREAD_ONCE_INIT;
+
+// producer thread exit, the drain thread releases the ring once empty
+static void
+GlueLogThreadExit(void* userdata)
+{
+    GlueLogRingT* ring = (GlueLogRingT*)userdata;
+    __atomic_store_n(&ring->dead, 1, __ATOMIC_RELEASE);
+}
+
+static void
+GlueLogKeyInit(void)
+{
+    pthread_key_create(&glueLogKey, GlueLogThreadExit);
+}
+
+static GlueLogRingT*
+GlueLogRingNew(unsigned long slots)
+{
+    GlueLogRingT* ring =
+      calloc(1, sizeof(GlueLogRingT) + slots * sizeof(GlueLogRecT));
+    if (!ring)
+        return NULL;
+    ring->mask = slots - 1;
+
+    pthread_once(&glueLogOnce, GlueLogKeyInit);
+    pthread_setspecific(glueLogKey, ring);
+    pthread_mutex_lock(&glueLog.mutex);
+    ring->next = glueLog.rings;
+    glueLog.rings = ring;
+    pthread_mutex_unlock(&glueLog.mutex);
+
+    glueLogRing = ring;
+    return ring;
+}
+
+static void
+GlueLogWrite(afb_api_t api,
+             int level,
+             int line,
+             const char* func,
+             const char* fmt,
+             ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    if (api)
+        afb_api_vverbose(api, level, NULL, line, func, fmt, args);
+    else
+        afb_vverbose(level, NULL, line, func, fmt, args);
+    va_end(args);
+}
+
+// write up to GLUE_LOG_BATCH records of each ring, return written count
+static unsigned long
+GlueLogDrain(void)
+{
+    unsigned long total = 0;
+
+    pthread_mutex_lock(&glueLog.mutex);
+    GlueLogRingT** prev = &glueLog.rings;
+    while (*prev) {
+        GlueLogRingT* ring = *prev;
+        int dead = __atomic_load_n(&ring->dead, __ATOMIC_ACQUIRE);
+        unsigned long tail = ring->tail;
+        unsigned long head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        unsigned long count = head - tail;
+
+        if (count > GLUE_LOG_BATCH)
+            count = GLUE_LOG_BATCH;
+        for (unsigned long idx = 0; idx < count; idx++) {
+            GlueLogRecT* rec = &ring->recs[(tail + idx) & ring->mask];
+            GlueLogWrite(rec->api,
+                         rec->level,
+                         rec->line,
+                         rec->func,
+                         "%s",
+                         rec->heap ? rec->heap : rec->text);
+            free(rec->heap);
+            rec->heap = NULL;
+        }
+        __atomic_store_n(&ring->tail, tail + count, __ATOMIC_RELEASE);
+        if (count) {
+            glueLog.drained += count;
+            glueLog.batches++;
+            total += count;
+        }
+
+        if (dead && tail + count == head) {
+            *prev = ring->next;
+            glueLog.queued += head;
+            glueLog.dropped += ring->dropped;
+            free(ring);
+            continue;
+        }
+        prev = &ring->next;
+    }
+    pthread_mutex_unlock(&glueLog.mutex);
+    return total;
+}
+
+static void*
+GlueLogDrainThread(void* userdata)
+{
+    struct timespec idle = { 0, GLUE_LOG_IDLE_MS * 1000000L };
+
+    for (;;) {
+        // read stop request first, so records queued before get a last pass
+        int running = __atomic_load_n(&glueLog.running, __ATOMIC_ACQUIRE);
+        unsigned long count = GlueLogDrain();
+        if (!running)
+            break;
+        if (!count)
+            nanosleep(&idle, NULL);
+    }
+    return NULL;
+}
+
+// stop the drain thread after a last flush, used by exit handler
+static void
+GlueLogStop(void)
+{
+    GlueLogAsyncSet(0);
+}
+
+// set per thread ring slots and start the drain thread, 0 stops it
+int
+GlueLogAsyncSet(long slots)
+{
+    pthread_t thread;
+    int stop = 0;
+
+    if (slots < 0 || slots > GLUE_LOG_SLOTS_MAX) {
+        PyErr_Format(PyExc_ValueError,
+                     "log ring slots should be within [0..%d]",
+                     GLUE_LOG_SLOTS_MAX);
+        return -1;
+    }
+
+    // round to a power of 2 so ring indexes are masked
+    unsigned long size = slots ? GLUE_LOG_SLOTS_MIN : 0;
+    while (size && size < (unsigned long)slots)
+        size <<= 1;
+
+    pthread_mutex_lock(&glueLog.mutex);
+    if (size && !glueLog.running) {
+        if (pthread_create(&thread, NULL, GlueLogDrainThread, NULL)) {
+            pthread_mutex_unlock(&glueLog.mutex);
+            PyErr_SetString(PyExc_RuntimeError, "fail to start log thread");
+            return -1;
+        }
+        glueLog.running = 1;
+        if (!glueLog.hooked) {
+            atexit(GlueLogStop);
+            glueLog.hooked = 1;
+        }
+        pthread_detach(thread);
+    } else if (!size && glueLog.running) {
+        __atomic_store_n(&glueLog.running, 0, __ATOMIC_RELEASE);
+        stop = 1;
+    }
+    __atomic_store_n(&glueLog.slots, size, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&glueLog.mutex);
+
+    // leftovers pushed while stopping are written synchronously, producers
+    // publishing after this pass see slots 0 and drain by themselves
+    if (stop) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (GlueLogDrain())
+            ;
+    }
+    return 0;
+}
+
+int
+GlueLogAsyncOn(void)
+{
+    return __atomic_load_n(&glueLog.slots, __ATOMIC_RELAXED) != 0;
+}
+
+// queue one record without blocking, return -1 when asynchronous log is off
+int
+GlueLogAsyncPush(GlueHandleT* handle,
+                 int level,
+                 int line,
+                 const char* func,
+                 const char* text)
+{
+    unsigned long slots = __atomic_load_n(&glueLog.slots, __ATOMIC_ACQUIRE);
+    GlueLogRingT* ring = glueLogRing;
+
+    if (!slots)
+        return -1;
+    if (!ring) {
+        ring = GlueLogRingNew(slots);
+        if (!ring)
+            return -1;
+    }
+
+    unsigned long head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    GlueLogRecT* rec = &ring->recs[head & ring->mask];
+    rec->level = level;
+    rec->line = line;
+    snprintf(rec->func, sizeof(rec->func), "%s", func ? func : "");
+
+    // request records keep their verb and a process wide request id
+    const char* verb = NULL;
+    int len;
+    if (handle->magic == GLUE_RQT_MAGIC_TAG) {
+        if (!handle->rqt.logid)
+            handle->rqt.logid = __atomic_add_fetch(
+              &glueLog.rqtid, 1, __ATOMIC_RELAXED);
+        rec->api = afb_req_get_api(handle->rqt.afb);
+        verb = afb_req_get_called_verb(handle->rqt.afb);
+        len = snprintf(rec->text,
+                       sizeof(rec->text),
+                       "[%s #%lu] %s",
+                       verb,
+                       handle->rqt.logid,
+                       text);
+    } else {
+        rec->api = GlueGetApi(handle);
+        len = snprintf(rec->text, sizeof(rec->text), "%s", text);
+    }
+
+    // long text goes to the heap, cut and counted only when out of memory
+    rec->heap = NULL;
+    if (len >= (int)sizeof(rec->text)) {
+        rec->heap = malloc((size_t)len + 1);
+        if (!rec->heap) {
+            memcpy(rec->text + sizeof(rec->text) - 4, "...", 4);
+            __atomic_fetch_add(&glueLog.truncated, 1, __ATOMIC_RELAXED);
+        } else if (verb) {
+            snprintf(rec->heap,
+                     (size_t)len + 1,
+                     "[%s #%lu] %s",
+                     verb,
+                     handle->rqt.logid,
+                     text);
+        } else {
+            memcpy(rec->heap, text, (size_t)len + 1);
+        }
+    }
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    // logasync(0) may have run its last drain before the record was
+    // published: write it now rather than leaving it in the ring
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&glueLog.slots, __ATOMIC_RELAXED))
+        while (GlueLogDrain())
+            ;
+    return 0;
+}
+
+// return asynchronous log counters as a python dict
+PyObject*
+GlueLogAsyncStats(void)
+{
+    unsigned long queued, dropped, threads = 0;
+
+    pthread_mutex_lock(&glueLog.mutex);
+    queued = glueLog.queued;
+    dropped = glueLog.dropped;
+    for (GlueLogRingT* ring = glueLog.rings; ring; ring = ring->next) {
+        queued += __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        threads++;
+    }
+    PyObject* statsP = Py_BuildValue("{s:k,s:k,s:k,s:k,s:k,s:k,s:k}",
+                                     "slots",
+                                     glueLog.slots,
+                                     "threads",
+                                     threads,
+                                     "queued",
+                                     queued,
+                                     "dropped",
+                                     dropped,
+                                     "drained",
+                                     glueLog.drained,
+                                     "batches",
+                                     glueLog.batches,
+                                     "truncated",
+                                     __atomic_load_n(&glueLog.truncated,
+                                                     __ATOMIC_RELAXED));
+    pthread_mutex_unlock(&glueLog.mutex);
+    return statsP;
+}
+
+// timer wheels, one per tick value, never released
+static GlueWheelT* glueWheels;
+#ifdef Py_GIL_DISABLED
+static PyMutex glueWheelsMutex;
+#endif
+
+#define GLUE_WHEEL_MASK0 ((1u << GLUE_WHEEL_BITS0) - 1)
+#define GLUE_WHEEL_MASKN ((1u << GLUE_WHEEL_BITSN) - 1)
+
+static void
+GlueWheelLink(GlueWheelTimerT** slot, GlueWheelTimerT* entry)
+{
+    entry->next = *slot;
+    if (*slot)
+        (*slot)->pprev = &entry->next;
+    *slot = entry;
+    entry->pprev = slot;
+}
+
+static void
+GlueWheelUnlink(GlueWheelTimerT* entry)
+{
+    *entry->pprev = entry->next;
+    if (entry->next)
+        entry->next->pprev = entry->pprev;
+    entry->next = NULL;
+    entry->pprev = NULL;
+}
+
+// arm entry on the slot of its due time, wheel should be locked
+static void
+GlueWheelInsert(GlueWheelT* wheel, GlueWheelTimerT* entry)
+{
+    GlueWheelTimerT** slot;
+    uint64_t expires =
+      (entry->due - wheel->base + wheel->tickns - 1) / wheel->tickns;
+
+    if (expires < wheel->tick)
+        expires = wheel->tick;
+    entry->expires = expires;
+
+    uint64_t delta = expires - wheel->tick;
+    if (delta <= GLUE_WHEEL_MASK0) {
+        slot = &wheel->tv0[expires & GLUE_WHEEL_MASK0];
+    } else {
+        int level = 0;
+        unsigned shift = GLUE_WHEEL_BITS0;
+        while (level < GLUE_WHEEL_LEVELS - 2 &&
+               delta >> (shift + GLUE_WHEEL_BITSN))
+            level++, shift += GLUE_WHEEL_BITSN;
+
+        // beyond last level range: park on its last slot, cascade later
+        if (delta >> (shift + GLUE_WHEEL_BITSN))
+            expires = wheel->tick + (1ull << (shift + GLUE_WHEEL_BITSN)) - 1;
+        slot = &wheel->tvn[level][(expires >> shift) & GLUE_WHEEL_MASKN];
+    }
+    GlueWheelLink(slot, entry);
+}
+
+// move current slot of an upper level down, return its index
+static unsigned
+GlueWheelCascade(GlueWheelT* wheel, int level)
+{
+    unsigned shift = GLUE_WHEEL_BITS0 + level * GLUE_WHEEL_BITSN;
+    unsigned index = (wheel->tick >> shift) & GLUE_WHEEL_MASKN;
+    GlueWheelTimerT* entry = wheel->tvn[level][index];
+
+    wheel->tvn[level][index] = NULL;
+    while (entry) {
+        GlueWheelTimerT* next = entry->next;
+        GlueWheelInsert(wheel, entry);
+        entry = next;
+    }
+    return index;
+}
+
+static GlueWheelT*
+GlueWheelGet(unsigned tickms)
+{
+    GlueWheelT* wheel;
+
+    GLUE_NOGIL_LOCK(glueWheelsMutex);
+    for (wheel = glueWheels; wheel; wheel = wheel->next)
+        if (wheel->tickms == tickms)
+            goto OnExit;
+
+    wheel = calloc(1, sizeof(GlueWheelT));
+    if (!wheel)
+        goto OnExit;
+    pthread_mutex_init(&wheel->mutex, NULL);
+    wheel->tickms = tickms;
+    wheel->tickns = tickms * 1000000ull;
+    wheel->base = GlueNowNs();
+    wheel->next = glueWheels;
+    glueWheels = wheel;
+
+OnExit:
+    GLUE_NOGIL_UNLOCK(glueWheelsMutex);
+    return wheel;
+}
+
+// start the afb timer of an idle wheel, wheel should be locked. Ticks that
+// elapsed while it was stopped are skipped.
+static int
+GlueWheelStart(GlueWheelT* wheel, uint64_t now)
+{
+    if (wheel->afb)
+        return 0;
+
+    wheel->tick = (now - wheel->base) / wheel->tickns + 1;
+    return afb_timer_create(&wheel->afb,
+                            0,
+                            0,
+                            0,
+                            0,
+                            wheel->tickms,
+                            0,
+                            GlueWheelCb,
+                            (void*)wheel,
+                            0);
+}
+
+// detach the afb timer of a wheel without armed timer, wheel should be
+// locked. The returned timer is released by the caller once unlocked.
+static afb_timer_t
+GlueWheelStop(GlueWheelT* wheel)
+{
+    afb_timer_t afb = NULL;
+
+    if (!wheel->count && !wheel->firing) {
+        afb = wheel->afb;
+        wheel->afb = NULL;
+    }
+    return afb;
+}
+
+// arm a timer handle on the wheel of given tick, period is in ms
+GlueWheelTimerT*
+GlueWheelAdd(GlueHandleT* glue,
+             unsigned tickms,
+             unsigned long period,
+             unsigned long count)
+{
+    GlueWheelT* wheel = GlueWheelGet(tickms);
+    if (!wheel)
+        return NULL;
+
+    GlueWheelTimerT* entry = calloc(1, sizeof(GlueWheelTimerT));
+    if (!entry)
+        return NULL;
+    entry->wheel = wheel;
+    entry->glue = glue;
+    entry->period = period * 1000000ull;
+    entry->count = count;
+
+    pthread_mutex_lock(&wheel->mutex);
+    uint64_t now = GlueNowNs();
+    if (GlueWheelStart(wheel, now)) {
+        pthread_mutex_unlock(&wheel->mutex);
+        free(entry);
+        return NULL;
+    }
+    entry->due = now + entry->period;
+    GlueWheelInsert(wheel, entry);
+    wheel->count++;
+    pthread_mutex_unlock(&wheel->mutex);
+    return entry;
+}
+
+// disarm a timer, return 1 when its callback runs and the wheel frees it
+int
+GlueWheelCancel(GlueWheelTimerT* entry)
+{
+    GlueWheelT* wheel = entry->wheel;
+
+    pthread_mutex_lock(&wheel->mutex);
+    if (entry->pprev) {
+        GlueWheelUnlink(entry);
+        wheel->count--;
+    }
+    int busy = entry->busy;
+    __atomic_store_n(&entry->cancelled, 1, __ATOMIC_RELAXED);
+    afb_timer_t afb = GlueWheelStop(wheel);
+    pthread_mutex_unlock(&wheel->mutex);
+
+    if (afb)
+        afb_timer_unref(afb);
+    if (!busy)
+        free(entry);
+    return busy;
+}
+
+// run wheel up to now and return the list of due timers, NULL when nothing
+// is due or when a previous tick is still running its callbacks
+GlueWheelTimerT*
+GlueWheelCollect(GlueWheelT* wheel, uint64_t now)
+{
+    GlueWheelTimerT *due = NULL, **last = &due;
+    uint64_t target = (now - wheel->base) / wheel->tickns;
+
+    pthread_mutex_lock(&wheel->mutex);
+    if (wheel->firing)
+        goto OnExit;
+    if (!wheel->count) {
+        wheel->tick = target + 1;
+        goto OnExit;
+    }
+
+    while (wheel->tick <= target) {
+        unsigned index = wheel->tick & GLUE_WHEEL_MASK0;
+        if (!index) {
+            for (int level = 0; level < GLUE_WHEEL_LEVELS - 1; level++)
+                if (GlueWheelCascade(wheel, level))
+                    break;
+        }
+
+        GlueWheelTimerT* entry = wheel->tv0[index];
+        wheel->tv0[index] = NULL;
+        wheel->tick++;
+        while (entry) {
+            GlueWheelTimerT* next = entry->next;
+            entry->next = NULL;
+            entry->pprev = NULL;
+            entry->busy = 1;
+            entry->fired++;
+            entry->decount = entry->count ? entry->count - entry->fired : 0;
+            wheel->count--;
+            *last = entry;
+            last = &entry->next;
+            entry = next;
+        }
+    }
+    wheel->firing = due != NULL;
+
+OnExit:
+    pthread_mutex_unlock(&wheel->mutex);
+    return due;
+}
+
+// record timer run statistics before its callback, return 0 when it was
+// cancelled by a previous callback of the same tick
+int
+GlueWheelRun(GlueWheelTimerT* entry, uint64_t now)
+{
+    if (__atomic_load_n(&entry->cancelled, __ATOMIC_RELAXED))
+        return 0;
+    GlueHistoAdd(&entry->drift, now > entry->due ? now - entry->due : 0);
+    if (entry->lastRun) {
+        uint64_t interval = now - entry->lastRun;
+        GlueHistoAdd(&entry->jitter,
+                     interval > entry->period ? interval - entry->period
+                                              : entry->period - interval);
+    }
+    entry->lastRun = now;
+    return 1;
+}
+
+// rearm a timer once its callback ran, return 1 when it was cancelled
+// meanwhile and should be released by the caller
+int
+GlueWheelRearm(GlueWheelTimerT* entry, uint64_t now)
+{
+    GlueWheelT* wheel = entry->wheel;
+
+    pthread_mutex_lock(&wheel->mutex);
+    entry->busy = 0;
+    int cancelled = entry->cancelled;
+    if (!cancelled && (!entry->count || entry->fired < entry->count)) {
+        entry->due += entry->period;
+        while (entry->due <= now) {
+            entry->due += entry->period;
+            entry->missed++;
+        }
+        GlueWheelInsert(wheel, entry);
+        wheel->count++;
+    }
+    pthread_mutex_unlock(&wheel->mutex);
+    return cancelled;
+}
+
+// end of a tick callbacks, the afb timer is stopped when no timer is left
+void
+GlueWheelDone(GlueWheelT* wheel)
+{
+    pthread_mutex_lock(&wheel->mutex);
+    wheel->firing = 0;
+    afb_timer_t afb = GlueWheelStop(wheel);
+    pthread_mutex_unlock(&wheel->mutex);
+
+    if (afb)
+        afb_timer_unref(afb);
+}
+
+json_object*
+GlueWheelStatsJson(GlueWheelTimerT* entry)
+{
+    GlueWheelT* wheel = entry->wheel;
+    json_object* statsJ = json_object_new_object();
+
+    pthread_mutex_lock(&wheel->mutex);
+    json_object_object_add(
+      statsJ, "tick", json_object_new_int64(wheel->tickms));
+    json_object_object_add(
+      statsJ, "period", json_object_new_int64(entry->period / 1000000));
+    json_object_object_add(
+      statsJ, "fired", json_object_new_int64(entry->fired));
+    json_object_object_add(
+      statsJ, "missed", json_object_new_int64(entry->missed));
+    pthread_mutex_unlock(&wheel->mutex);
+    json_object_object_add(statsJ, "drift", GlueHistoJson(&entry->drift));
+    json_object_object_add(statsJ, "jitter", GlueHistoJson(&entry->jitter));
+    return statsJ;
+}
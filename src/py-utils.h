@@ -24,6 +24,7 @@
 
 #include <Python.h>
 #include <json-c/json.h>
+#include <stdbool.h>
 
 void
 PyThreadSave(void);
@@ -36,8 +37,14 @@ PyInfoDbg(GlueHandleT *handle,
           const char *funcname,
           const char *format,
           ...);
+int
+GlueWantsLog(GlueHandleT *handle, int level);
 void
-PyPrintMsg(enum afb_syslog_levels level, PyObject *self, PyObject *args);
+PyPrintMsg(enum afb_syslog_levels level,
+           PyObject *self,
+           PyObject *const *args,
+           Py_ssize_t nargs,
+           PyObject *kwnames);
 void
 GlueVerbose(GlueHandleT *afbHandle,
             int level,
@@ -64,11 +71,130 @@ json_object *
 pyObjToJson(PyObject *objP, int *hasError);
 PyObject *
 jsonToPyObj(json_object *argsJ);
+int
+GlueKeyCacheSetSize(long size);
+PyObject *
+GlueKeyCacheStats(void);
+PyObject *
+GlueAioLoop(void);
+PyObject *
+GlueAioFutureNew(void);
+int
+GlueAioResolve(PyObject *futureP, PyObject *resultP);
+PyObject *
+GlueAioRun(PyObject *coroP);
+PyObject *
+PyResponseNew(int status, unsigned nreplies, const afb_data_t *replies);
+void
+GluePyObjectRelease(void *userdata);
+bool
+_convert_py_argument_to_afb_data(PyObject *pyArg, afb_data_t *out, int index);
+char *
+pyObjToJsonString(PyObject *objP, size_t *len);
+bool
+GlueReplyConvert(PyObject *pyArg,
+                 afb_data_t *out,
+                 int index,
+                 GlueEncodingE encoding);
 void
 PyFreeJsonCtx(json_object *configJ, void *userdata);
 
+typedef enum
+{
+    GLUE_POOL_RQT,  /**< GlueHandleT used by requests */
+    GLUE_POOL_CALL, /**< GlueCallHandleT used by callasync/jobpost */
+    GLUE_POOL_DATA, /**< afb_data_t arrays spilled out of GlueDataArrayT */
+    GLUE_POOL_COUNT
+} GluePoolE;
+
+// afb_data_t array keeping GLUE_DATA_INLINE slots inline, larger arrays spill
+// to a pooled buffer of GLUE_DATA_POOLED slots, then to the heap
+#define GLUE_DATA_INLINE 8
+#define GLUE_DATA_POOLED 128
+
+typedef struct
+{
+    afb_data_t *data;
+    size_t count;
+    afb_data_t inlined[GLUE_DATA_INLINE];
+} GlueDataArrayT;
+
+afb_data_t *
+GlueDataAlloc(size_t count);
+void
+GlueDataFree(afb_data_t *data, size_t count);
+afb_data_t *
+GlueDataArrayInit(GlueDataArrayT *array, size_t count);
+void
+GlueDataArrayRelease(GlueDataArrayT *array);
+
+uint64_t
+GlueNowNs(void);
+void
+GlueHistoAdd(GlueHistoT *histo, uint64_t ns);
+json_object *
+GlueHistoJson(GlueHistoT *histo);
+void
+GlueGilEnsure(GlueGilT *gil, GlueGilPointE point);
+void
+GlueGilRelease(GlueGilT *gil, GlueVerbT *verb);
+json_object *
+GlueStatsJson(afb_api_t apiv4);
+
+void *
+GluePoolAlloc(GluePoolE pool);
+void
+GluePoolFree(GluePoolE pool, void *item);
+PyObject *
+GluePoolStats(void);
+
+// asynchronous log records, ring slots per producer thread. Messages longer
+// than GLUE_LOG_TEXT are copied to the heap rather than truncated.
+#define GLUE_LOG_SLOTS_MIN 16
+#define GLUE_LOG_SLOTS_MAX 4096
+#define GLUE_LOG_BATCH 64   // records written per ring and drain pass
+#define GLUE_LOG_IDLE_MS 5  // drain thread sleep when rings are empty
+#define GLUE_LOG_FUNC 48
+#define GLUE_LOG_TEXT 256
+int
+GlueLogAsyncSet(long slots);
+int
+GlueLogAsyncOn(void);
+int
+GlueLogAsyncPush(GlueHandleT *handle,
+                 int level,
+                 int line,
+                 const char *func,
+                 const char *text);
+PyObject *
+GlueLogAsyncStats(void);
+
+GlueWheelTimerT *
+GlueWheelAdd(GlueHandleT *glue,
+             unsigned tickms,
+             unsigned long period,
+             unsigned long count);
+int
+GlueWheelCancel(GlueWheelTimerT *entry);
+GlueWheelTimerT *
+GlueWheelCollect(GlueWheelT *wheel, uint64_t now);
+int
+GlueWheelRun(GlueWheelTimerT *entry, uint64_t now);
+int
+GlueWheelRearm(GlueWheelTimerT *entry, uint64_t now);
+void
+GlueWheelDone(GlueWheelT *wheel);
+json_object *
+GlueWheelStatsJson(GlueWheelTimerT *entry);
+
 GlueHandleT *
 PyRqtNew(afb_req_t afbRqt);
+PyObject *
+PyRqtObjectNew(GlueHandleT *glue);
+GlueHandleT *
+PyGlueHandleGet(PyObject *handleP);
+PyObject *
+PyGlueHandleNew(GlueHandleT *glue);
 void
 PyRqtAddref(GlueHandleT *pyRqt);
 void
@@ -78,12 +204,78 @@ InitPrivateData(GlueHandleT *glue);
 
 afb_api_t
 GlueGetApi(GlueHandleT *glue);
+const char *
+GlueVerbPrepare(GlueHandleT *glue, json_object *verbJ);
+const char *
+GlueVerbsPrepare(GlueHandleT *glue, json_object *apiJ);
+const char *
+GlueVerbsCompile(afb_api_t apiv4);
+const char *
+GlueEventsCompile(json_object *apiJ);
+GlueEvtDispatchT *
+GlueEvtDispatchGet(afb_api_t apiv4, int create);
+void
+GlueEvtDispatchLock(GlueEvtDispatchT *dispatch);
+void
+GlueEvtDispatchUnlock(GlueEvtDispatchT *dispatch);
+GlueEvtPatternT *
+GlueEvtDispatchFind(GlueEvtDispatchT *dispatch, const char *pattern);
+const char *
+GlueEvtDispatchAdd(GlueEvtDispatchT *dispatch,
+                   const char *pattern,
+                   GlueHandleT *handle);
+int
+GlueEvtDispatchDel(GlueEvtDispatchT *dispatch, const char *pattern);
+void
+GlueEvtDispatchEnter(GlueEvtDispatchT *dispatch);
+void
+GlueEvtDispatchLeave(GlueEvtDispatchT *dispatch);
+unsigned
+GlueEvtDispatchMatch(GlueEvtDispatchT *dispatch,
+                     const char *name,
+                     GlueEvtPatternT **matches);
+PyObject *
+GlueEvtDispatchStats(GlueEvtDispatchT *dispatch);
 int
 GlueAfbReply(GlueHandleT *glue, long status, long nbreply, afb_data_t *reply);
 const char *
 PyPushAfbReply(PyObject *responseP, int start, unsigned nreplies, const afb_data_t *replies);
 PyObject *
 convert_AfbData_to_PyObject(afb_data_t data);
+PyObject *
+convert_AfbData_to_PyView(afb_data_t data, int jsonview);
+extern PyTypeObject PyJsonViewType;
+PyObject *
+PyJsonViewNew(json_object *valueJ);
+json_object *
+PyJsonViewGetJson(PyObject *objP);
+extern PyTypeObject PyAfbDataType;
+extern PyTypeObject PyLazyType;
+
+#if PY_VERSION_HEX < 0x03090000
+// PyObject_Vectorcall is public from CPython 3.9
+#define PyObject_Vectorcall _PyObject_Vectorcall
+#endif
+
+// python callback argument vector. Slot 0 of the underlying buffer stays free
+// so that callees may use PY_VECTORCALL_ARGUMENTS_OFFSET, and small vectors
+// live on the caller stack.
+#define GLUE_ARGV_SMALL 8
+typedef struct
+{
+    PyObject **argv;
+    size_t count;
+    PyObject *small[GLUE_ARGV_SMALL + 1];
+} GlueArgvT;
+
+int
+GlueArgvInit(GlueArgvT *args, size_t count);
+void
+GlueArgvClear(GlueArgvT *args);
+PyObject *
+GlueArgvCall(PyObject *callableP, GlueArgvT *args);
+const char *
+PyPushAfbArgv(PyObject **argv, unsigned nreplies, const afb_data_t *replies);
 
 #if PY_VERSION_HEX >= 0x030a0000
 // Py_NewRef has been introduced in CPython 3.10
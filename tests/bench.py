@@ -0,0 +1,97 @@
+# Micro-benchmark of libafb per-call overhead.
+#
+# Run it against two builds of the module, saving each result, then compare
+# them (the comparison does not need libafb):
+#   PYTHONPATH=before/src python3 tests/bench.py -o before.json [loops]
+#   PYTHONPATH=build/src python3 tests/bench.py -o after.json [loops]
+#   python3 tests/bench.py --compare before.json after.json
+
+import json
+import sys
+import time
+
+
+def compare(before_path, after_path):
+    with open(before_path) as f:
+        before = json.load(f)
+    with open(after_path) as f:
+        after = json.load(f)
+    print(f"{'':<32} {'before':>10} {'after':>10} {'delta':>8}")
+    for label, old in before["results"].items():
+        new = after["results"].get(label)
+        if new is None:
+            continue
+        print(f"{label:<32} {old:10.1f} {new:10.1f} {(new - old) / old:+8.1%}")
+
+
+if len(sys.argv) == 4 and sys.argv[1] == "--compare":
+    compare(sys.argv[2], sys.argv[3])
+    sys.exit(0)
+
+import libafb
+
+args = sys.argv[1:]
+OUTPUT = None
+if args[:1] == ["-o"]:
+    OUTPUT, args = args[1], args[2:]
+LOOPS = int(args[0]) if args else 100000
+RESULTS = {}
+
+
+def bench(label, func, *args):
+    start = time.perf_counter_ns()
+    for _ in range(LOOPS):
+        func(*args)
+    elapsed = time.perf_counter_ns() - start
+    RESULTS[label] = elapsed / LOOPS
+    print(f"{label:<32} {elapsed / LOOPS:10.1f} ns/call")
+
+
+def verb_cb(rqt, *args):
+    return 0, *args
+
+
+def explicit_cb(rqt, *args):
+    libafb.reply(rqt, 0, *args)
+
+
+_binder = libafb.binder({"uid": "py-bench", "verbose": 0, "port": 0})
+_api = libafb.apiadd(
+    {
+        "uid": "py-bench",
+        "api": "py-bench",
+        "verbose": 0,
+        "export": "private",
+        "verbs": [
+            {"uid": "py-echo", "verb": "echo", "callback": verb_cb},
+            {"uid": "py-reply", "verb": "reply", "callback": explicit_cb},
+        ],
+    }
+)
+
+
+def _loop_cb(binder, userdata):
+    bench("config(binder, 'uid')", libafb.config, binder, "uid")
+    bench("debug(binder, fmt)", libafb.debug, binder, "bench %d", 42)
+    bench("callsync echo()", libafb.callsync, binder, "py-bench", "echo")
+    bench("callsync echo(int)", libafb.callsync, binder, "py-bench", "echo", 42)
+    bench(
+        "callsync echo(int, str, float)",
+        libafb.callsync,
+        binder,
+        "py-bench",
+        "echo",
+        42,
+        "toto",
+        3.14,
+    )
+    bench("callsync reply(int)", libafb.callsync, binder, "py-bench", "reply", 42)
+    if OUTPUT:
+        with open(OUTPUT, "w") as f:
+            json.dump(
+                {"python": sys.version, "loops": LOOPS, "results": RESULTS}, f, indent=1
+            )
+    return 1
+
+
+libafb.loopstart(_binder, _loop_cb, None)
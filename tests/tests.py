@@ -28,27 +28,92 @@ def silence_stderr():
         os.close(stderr_copy)
 
 from contextlib import redirect_stderr, redirect_stdout
+import time
+import weakref
+
+def wait_for(condition, timeout=2.0):
+    "Poll condition while binder threads deliver events and timers"
+    deadline = time.monotonic() + timeout
+    while not condition() and time.monotonic() < deadline:
+        time.sleep(0.01)
+    return condition()
+
+# py-binding api, its events and verbs are shared by the tests below, see
+# setup_binding()
+api_handler = my_event = throttled = coalesced = None
+
+
+class Buffer(bytearray):
+    "bytearray that can be weakly referenced"
 
-def test_event_handler():
-    def verb_cb(handle, *args):
-        assert handle
-        assert len(args)
-        match args[0]:
-            case "ping":
-                return 0, *args[1:]
-            case "subscribe":
-                r = libafb.evtsubscribe(handle, my_event)
-                assert r is None
-                return 0
-            case "emit":
-                evt_args = args[1:]
-                r = libafb.evtpush(my_event, *evt_args)
-                assert r is None
-                return 0
-            case _:
-                assert False
-
-        return 1
+
+buffers = {"bytes": b"\x00raw bytes"}
+
+
+def verb_cb(handle, *args):
+    assert handle
+    assert isinstance(handle, libafb.Request)
+    assert len(args)
+    match args[0]:
+        case "ping":
+            return 0, *args[1:]
+        case "reply":
+            handle.reply(0, *args[1:])
+            return None
+        case "sleep":
+            time.sleep(args[1])
+            return 0
+        case "subscribe":
+            r = libafb.evtsubscribe(handle, my_event)
+            assert r is None
+            return 0
+        case "subscribe-policy":
+            assert libafb.evtsubscribe(handle, throttled) is None
+            assert libafb.evtsubscribe(handle, coalesced) is None
+            return 0
+        case "emit":
+            evt_args = args[1:]
+            r = libafb.evtpush(my_event, *evt_args)
+            assert r is None
+            return 0
+        case "memoryview":
+            view = args[1]
+            assert isinstance(view, memoryview) and view.readonly
+            with assert_raises(TypeError):
+                view[0] = 0
+            return 0, bytes(view), len(view)
+        case "buffers":
+            # only the reply keeps the sources alive once returned
+            source = Buffer(b"\x00\x01array")
+            view = memoryview(source)[1:]
+            buffers["array"] = weakref.ref(source)
+            buffers["view"] = weakref.ref(view)
+            return 0, buffers["bytes"], source, view
+        case "emitmany":
+            r = libafb.evtpushmany(my_event, [args[1:], args[1]])
+            assert len(r) == 2 and min(r) >= 0
+            r = libafb.evtpushmany([(my_event, *args[1:])])
+            assert len(r) == 1 and r[0] >= 0
+            return 0
+        case _:
+            assert False
+
+    return 1
+
+
+async def async_cb(handle, *args):
+    r = await libafb.call(handle, "py-binding", "verb", "ping", *args)
+    return r.status, *r.args
+
+
+def view_cb(handle, doc):
+    assert isinstance(doc, libafb.JsonView)
+    assert "text" in doc and len(doc) == 3
+    return 0, doc["list"][-1], doc.get("missing", 7), doc
+
+
+def setup_binding():
+    global api_handler, my_event, throttled, coalesced
 
     my_api = {
         "uid": "py-binding",
@@ -57,15 +122,23 @@ def test_event_handler():
         "info": "py api test",
         "verbose": 9,
         "export": "public",
+        "stats": True,
         "verbs": [
             {"uid": "py-verb", "verb": "verb", "callback": verb_cb},
+            {"uid": "py-json", "verb": "json", "callback": verb_cb, "encoding": "json"},
+            {"uid": "py-view", "verb": "view", "callback": view_cb, "jsonview": True},
+            {"uid": "py-async", "verb": "async", "callback": async_cb},
         ],
     }
     api_handler = libafb.apiadd(my_api)
     assert api_handler
 
     my_event = libafb.evtnew(api_handler, "my_event")
+    throttled = libafb.evtnew(api_handler, "throttled", {"rate": 10})
+    coalesced = libafb.evtnew(api_handler, "coalesced", {"coalesce": 50})
+
 
+def test_event_handler():
     ret = libafb.callsync(_binder, "py-binding", "verb", "ping", None, [42], 43, "toto", 3.14)
     assert (ret.status, ret.args) == (0, (None, [42], 43, "toto", 3.14))
 
@@ -121,6 +194,320 @@ def test_event_handler():
     r = libafb.evtdelete(_binder, "py-binding/*")
     assert r is None
 
+
+def test_arguments():
+    # bytes arguments reach the verb as a read-only memoryview on the afb data
+    ret = libafb.callsync(_binder, "py-binding", "verb", "memoryview", b"\x00\xffraw")
+    assert (ret.status, ret.args) == (0, (b"\x00\xffraw", 5))
+
+
+def test_init_dispatch():
+    # verbs are dispatched while the api is still being created
+    init = []
+
+    def init_control(handle, state):
+        if state == "init":
+            r = libafb.callsync(handle, "py-init", "verb", "ping", 1)
+            init.append((r.status, r.args))
+        return 0
+
+    libafb.apiadd(
+        {
+            "uid": "py-init",
+            "api": "py-init",
+            "control": init_control,
+            "verbs": [{"uid": "py-init-verb", "verb": "verb", "callback": verb_cb}],
+        }
+    )
+    assert wait_for(lambda: init)
+    assert init == [(0, (1,))]
+
+
+def test_pools():
+    libafb.callsync(_binder, "py-binding", "verb", "ping")
+    stats = libafb.poolstats()
+    assert stats["rqt"]["hit"] + stats["rqt"]["miss"] > 0
+
+
+def test_replies():
+    ret = libafb.callsync(_binder, "py-binding", "verb", "reply", 42, "toto")
+    assert (ret.status, ret.args) == (0, (42, "toto"))
+
+    # bytes, bytearray and memoryview replies borrow their buffer until the
+    # reply is released, then come back as bytearray copies
+    refs = sys.getrefcount(buffers["bytes"])
+    ret = libafb.callsync(_binder, "py-binding", "verb", "buffers")
+    assert (ret.status, ret.args) == (0, (b"\x00raw bytes", b"\x00\x01array", b"\x01array"))
+    assert all(type(arg) is bytearray for arg in ret.args)
+    assert wait_for(lambda: buffers["array"]() is None and buffers["view"]() is None)
+    assert wait_for(lambda: sys.getrefcount(buffers["bytes"]) == refs)
+
+
+def test_json():
+    doc = {"text": "a\"b\\c\n\x01é", "list": [1, -2.5, 1e300, True, None], "tuple": (3,)}
+    ret = libafb.callsync(_binder, "py-binding", "json", "ping", doc)
+    assert (ret.status, ret.args) == (0, ({**doc, "tuple": [3]},))
+
+    # replies larger than the kept serializer buffer
+    big = ["x" * 1024] * 100
+    ret = libafb.callsync(_binder, "py-binding", "json", "ping", big, doc)
+    assert (ret.status, ret.args) == (0, (big, {**doc, "tuple": [3]}))
+
+
+def test_jsonview():
+    doc = {"text": "a\"b\\c\n\x01é", "list": [1, -2.5, 1e300, True, None], "tuple": (3,)}
+    ret = libafb.callsync(_binder, "py-binding", "view", doc)
+    assert (ret.status, ret.args) == (0, (None, 7, {**doc, "tuple": [3]}))
+
+
+def test_keycache():
+    libafb.callsync(_binder, "py-binding", "json", "ping", {"key": 1}, {"key": 2})
+    stats = libafb.keycache()
+    assert stats["size"] == 256 and stats["hit"] > 0
+
+    # empty keys with the cache disabled
+    assert libafb.keycache(0)["size"] == 0
+    ret = libafb.callsync(_binder, "py-binding", "json", "ping", {"": 1})
+    assert (ret.status, ret.args) == (0, ({"": 1},))
+    assert libafb.keycache(256)["size"] == 256
+
+
+def test_evtpushmany():
+    ret = libafb.callsync(_binder, "py-binding", "verb", "subscribe")
+    assert (ret.status, ret.args) == (0, ())
+
+    # evtpush and evtpushmany encode payloads the same way
+    pushed = []
+
+    def on_push(handle, event_name, user_data, *args):
+        pushed.append(tuple((type(a), bytes(a) if isinstance(a, memoryview) else a) for a in args))
+
+    r = libafb.evthandler(
+        _binder,
+        {"api": "py-binding", "pattern": "py-binding/my_event", "callback": on_push},
+    )
+    assert r is None
+    assert libafb.evtpush(my_event, "text", b"raw") is None
+    assert wait_for(lambda: len(pushed) == 1)
+    assert min(libafb.evtpushmany(my_event, [("text", b"raw")])) >= 0
+    assert wait_for(lambda: len(pushed) == 2)
+    assert pushed[0] == pushed[1] == ((str, "text"), (memoryview, b"raw"))
+    assert libafb.evtdelete(_binder, "py-binding/my_event") is None
+
+    r = libafb.callsync(_binder, "py-binding", "verb", "emitmany", 1, 2)
+    assert (r.status, r.args) == (0, ())
+    # let the pushed events go before the next test registers handlers
+    time.sleep(0.05)
+
+
+def test_event_policies():
+    with silence_stderr(), assert_raises(RuntimeError):
+        libafb.evtnew(api_handler, "bad", {"coalesce": 10, "rate": 10})
+
+    # publishing policies: rate pushes the first value at once, both push
+    # only the latest value of a burst at the end of the period
+    received = {}
+
+    def on_policy(handle, event_name, user_data, *args):
+        received.setdefault(event_name, []).append((time.monotonic(), *args))
+
+    for label in ("throttled", "coalesced"):
+        r = libafb.evthandler(
+            _binder,
+            {"api": "py-binding", "pattern": "py-binding/" + label, "callback": on_policy},
+        )
+        assert r is None
+    r = libafb.callsync(_binder, "py-binding", "verb", "subscribe-policy")
+    assert (r.status, r.args) == (0, ())
+
+    start = time.monotonic()
+    for i in range(5):
+        assert libafb.evtpush(throttled, i) is None
+        assert libafb.evtpush(coalesced, i) is None
+    assert wait_for(lambda: len(received.get("py-binding/throttled", [])) == 2)
+    assert wait_for(lambda: len(received.get("py-binding/coalesced", [])) == 1)
+    time.sleep(0.2)
+    # delivery can only be late, so timing is checked with lower bounds at
+    # half the period
+    (first, v0), (last, v4) = received["py-binding/throttled"]
+    assert (v0, v4) == (0, 4) and start <= first < last
+    assert last - start >= 0.05
+    [(when, value)] = received["py-binding/coalesced"]
+    assert value == 4 and when - start >= 0.025
+    for label in ("throttled", "coalesced"):
+        assert libafb.evtdelete(_binder, "py-binding/" + label) is None
+
+
+def test_event_dispatch():
+    ret = libafb.callsync(_binder, "py-binding", "verb", "subscribe")
+    assert (ret.status, ret.args) == (0, ())
+
+    r = libafb.evthandler(
+        _binder,
+        {"api": "py-binding", "pattern": "py-binding/*", "callback": lambda *args: None},
+    )
+    assert r is None
+    assert "py-binding/*" in libafb.evtstats(_binder)
+    r = libafb.evtdelete(_binder, "py-binding/*")
+    assert r is None
+
+    # a handler deleting its own pattern and a matching sibling
+    called = []
+
+    def on_delete(handle, event_name, user_data, *args):
+        called.append(user_data)
+        libafb.evtdelete(_binder, "py-binding/my_*")
+        libafb.evtdelete(_binder, "py-binding/my_event")
+
+    for pattern in ("py-binding/my_*", "py-binding/my_event"):
+        r = libafb.evthandler(
+            _binder,
+            {"api": "py-binding", "pattern": pattern, "callback": on_delete},
+            pattern,
+        )
+        assert r is None
+
+    for i in range(2):
+        r = libafb.callsync(_binder, "py-binding", "verb", "emit", i)
+        assert (r.status, r.args) == (0, ())
+        assert wait_for(lambda: called)
+    time.sleep(0.05)
+    assert called == ["py-binding/my_*"]
+    assert libafb.evtstats(_binder) == {}
+
+
+def test_call_async():
+    async def acall():
+        r = await libafb.call(_binder, "py-binding", "verb", "ping", 1)
+        return r.status, r.args
+
+    assert libafb.aiorun(acall()).result(timeout=5) == (0, (1,))
+
+
+def test_async_verb():
+    r = libafb.callsync(_binder, "py-binding", "async", 42, "toto")
+    assert (r.status, r.args) == (0, (42, "toto"))
+
+
+def test_callmany():
+    rs = libafb.callmany(
+        _binder,
+        [("py-binding", "verb", "ping", i) for i in range(8)],
+        5,
+    )
+    assert [(r.status, r.args) for r in rs] == [(0, (i,)) for i in range(8)]
+
+    # the slow subcall completes after callmany timed out
+    rs = libafb.callmany(
+        _binder,
+        [("py-binding", "verb", "sleep", 1.5), ("py-binding", "verb", "ping", 1)],
+        1,
+    )
+    assert rs[0].status < 0 and (rs[1].status, rs[1].args) == (0, (1,))
+    time.sleep(1)
+    rs = libafb.callmany(_binder, [("py-binding", "verb", "ping", 2)], 5)
+    assert (rs[0].status, rs[0].args) == (0, (2,))
+
+
+def test_reply_count():
+    # replies are no longer capped, large counts spill out of the inline slots
+    for n in (8, 9, 128, 129, 500):
+        items = tuple(range(n))
+        ret = libafb.callsync(_binder, "py-binding", "verb", "ping", *items)
+        assert (ret.status, ret.args) == (0, items)
+        ret = libafb.callsync(_binder, "py-binding", "verb", "reply", *items)
+        assert (ret.status, ret.args) == (0, items)
+    assert libafb.poolstats()["data"]["miss"] > 0
+
+
+def test_stats():
+    libafb.callsync(_binder, "py-binding", "verb", "ping")
+    stats = libafb.stats(api_handler)
+    assert stats["gil"]["verb"]["wait"]["count"] > 0
+    assert stats["verbs"]["verb"]["gil"]["hold"]["count"] > 0
+    verb = stats["verbs"]["verb"]
+    assert verb["calls"] > 0 and verb["latency"]["count"] > 0
+    assert verb["exec"]["count"] == verb["calls"]
+    latency = verb["latency"]
+    assert sum(count for _, count in latency["buckets"]) == latency["count"]
+    assert latency["p50"] <= latency["p99"] <= latency["max"]
+    r = libafb.callsync(_binder, "py-binding", "stats")
+    assert r.status == 0 and "verb" in r.args[0]["verbs"]
+
+
+def test_info_cache():
+    info = libafb.callsync(_binder, "py-binding", "info").args[0]
+    assert info == libafb.callsync(_binder, "py-binding", "info").args[0]
+    libafb.verbadd(
+        api_handler, {"uid": "py-added", "verb": "added", "callback": verb_cb}, None
+    )
+    verbs = libafb.callsync(_binder, "py-binding", "info").args[0]["groups"][0]["verbs"]
+    assert "added" in [v["verb"] for v in verbs]
+
+
+def test_lazy_logging():
+    evaluated = []
+    libafb.error(_binder, "lazy=%s", libafb.lazy(lambda: evaluated.append(1) or "done"))
+    assert evaluated == [1]
+
+    # plain callables are logged, not called
+    libafb.error(_binder, "callback=%s", lambda: evaluated.append(2))
+    assert evaluated == [1]
+
+    # dropped messages do not evaluate their arguments
+    quiet = libafb.apiadd({"uid": "py-quiet", "api": "py-quiet", "verbose": 0})
+    libafb.debug(quiet, "lazy=%s", libafb.lazy(lambda: evaluated.append(3)))
+    assert evaluated == [1]
+    with assert_raises(TypeError):
+        libafb.lazy(42)
+
+
+def test_logasync():
+    libafb.logasync(100)
+    args = list(range(12))
+    libafb.error(_binder, "%d " * len(args), *args, test="logasync")
+    libafb.error(_binder, "long=%s", "x" * 4096)
+    stats = libafb.logasync(0)
+    assert stats["slots"] == 0 and stats["queued"] >= 2
+    assert stats["truncated"] == 0
+    assert stats["drained"] + stats["dropped"] == stats["queued"]
+
+
+def test_wheel_timers():
+    fired = []
+
+    def timer_cb(timer, count, userdata):
+        fired.append(userdata)
+
+    config = {"uid": "py-wheel", "callback": timer_cb, "period": 20, "count": 3}
+    gil = libafb.stats()["gil"]["timer"]["wait"]["count"]
+    timer = libafb.timernew(api_handler, dict(config, wheel=True), "a")
+    sibling = libafb.timernew(api_handler, dict(config, uid="py-wheel2", wheel=True), "b")
+    stats = libafb.timerstats(timer)
+    assert (stats["tick"], stats["period"], stats["fired"]) == (10, 20, 0)
+    assert "p99" in stats["drift"] and "p99" in stats["jitter"]
+
+    # both timers share their ticks and expire after count runs
+    assert wait_for(lambda: len(fired) == 6)
+    time.sleep(0.1)
+    assert sorted(fired) == ["a"] * 3 + ["b"] * 3
+    assert libafb.stats()["gil"]["timer"]["wait"]["count"] - gil < 6
+    stats = libafb.timerstats(timer)
+    assert stats["fired"] == 3 and stats["drift"]["count"] == 3
+    assert stats["jitter"]["count"] == 2
+    libafb.timerunref(timer)
+    libafb.timerunref(sibling)
+
+    # the wheel restarts its afb timer once idle
+    timer = libafb.timernew(api_handler, dict(config, wheel=True, count=1), "c")
+    assert wait_for(lambda: len(fired) == 7) and fired[-1] == "c"
+    libafb.timerunref(timer)
+
+    timer = libafb.timernew(api_handler, config, None)
+    with assert_raises(RuntimeError):
+        libafb.timerstats(timer)
+    libafb.timerunref(timer)
+
 def test_api():
     def my_control(
         handle, state: str
@@ -151,7 +538,27 @@ def _loop_cb(handle, userdata):
     assert handle
     assert userdata == 42
 
+    setup_binding()
     test_event_handler()
+    test_arguments()
+    test_init_dispatch()
+    test_pools()
+    test_replies()
+    test_json()
+    test_jsonview()
+    test_keycache()
+    test_evtpushmany()
+    test_event_policies()
+    test_event_dispatch()
+    test_call_async()
+    test_async_verb()
+    test_callmany()
+    test_reply_count()
+    test_stats()
+    test_info_cache()
+    test_lazy_logging()
+    test_logasync()
+    test_wheel_timers()
     #test_api()
 
     return 1